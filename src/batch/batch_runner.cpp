@@ -0,0 +1,142 @@
+#include "batch_runner.h"
+#include <chrono>
+#include <thread>
+
+static std::string trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(" \t\r\n");
+    return str.substr(first, last - first + 1);
+}
+
+BatchRunner::BatchRunner(Executor& executor) : executor(executor) {
+}
+
+size_t BatchRunner::run(std::istream& script, std::ostream& results, std::ostream& diagnostics) {
+    reader_done = false;
+    std::thread reader(&BatchRunner::read_loop, this, std::ref(script));
+    
+    size_t failed = 0;
+    Statement statement;
+    while (pop(statement)) {
+        std::ostream& messages = executor.output_mode() == OutputMode::TABLE ? results : diagnostics;
+        bool success = false;
+        if (statement.shell_command) {
+            success = run_shell_command(statement.sql, messages);
+        } else {
+            try {
+                success = executor.execute_parsed(statement.cmd, statement.sql, statement.parse_seconds,
+                                                  results, messages);
+            } catch (const std::exception& e) {
+                messages << "Error: " << e.what() << "\n";
+            }
+        }
+        if (!success) failed++;
+    }
+    
+    reader.join();
+    return failed;
+}
+
+// Statements end at a ';' outside quotes and may span lines. "--" starts a
+// comment that runs to the end of the line. A line starting with '.' outside
+// a statement is a shell command.
+void BatchRunner::read_loop(std::istream& script) {
+    std::string line;
+    std::string statement;
+    bool in_quote = false;
+    
+    while (std::getline(script, line)) {
+        if (!in_quote && trim(statement).empty() && trim(line).compare(0, 1, ".") == 0) {
+            enqueue_shell_command(trim(line));
+            statement.clear();
+            continue;
+        }
+        
+        for (size_t i = 0; i < line.size(); ++i) {
+            char c = line[i];
+            if (c == '\'') {
+                in_quote = !in_quote;
+            } else if (!in_quote && c == '-' && i + 1 < line.size() && line[i + 1] == '-') {
+                break;
+            } else if (!in_quote && c == ';') {
+                enqueue_statement(statement);
+                statement.clear();
+                continue;
+            }
+            statement += c;
+        }
+        
+        // The parser matches statements on a single line, so line breaks
+        // become spaces unless they are part of a string literal.
+        statement += in_quote ? '\n' : ' ';
+    }
+    enqueue_statement(statement);
+    
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    reader_done = true;
+    queue_ready.notify_all();
+}
+
+void BatchRunner::enqueue_statement(const std::string& text) {
+    Statement statement;
+    statement.sql = trim(text);
+    if (statement.sql.empty()) return;
+    statement.sql += ';';
+    
+    auto parse_start = std::chrono::steady_clock::now();
+    statement.cmd = parser.parse_command(statement.sql);
+    statement.parse_seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - parse_start).count();
+    push(std::move(statement));
+}
+
+void BatchRunner::enqueue_shell_command(const std::string& line) {
+    Statement statement;
+    statement.sql = line;
+    statement.shell_command = true;
+    push(std::move(statement));
+}
+
+void BatchRunner::push(Statement statement) {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    queue_space.wait(lock, [this] { return queue.size() < QUEUE_CAPACITY; });
+    queue.push_back(std::move(statement));
+    queue_ready.notify_one();
+}
+
+bool BatchRunner::pop(Statement& statement) {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    queue_ready.wait(lock, [this] { return !queue.empty() || reader_done; });
+    if (queue.empty()) return false;
+    
+    statement = std::move(queue.front());
+    queue.pop_front();
+    queue_space.notify_one();
+    return true;
+}
+
+// Shell commands are queued with the statements so they take effect at the
+// same point in the script.
+bool BatchRunner::run_shell_command(const std::string& line, std::ostream& messages) {
+    if (line == ".timer on" || line == ".timer off") {
+        executor.set_timer(line == ".timer on");
+        return true;
+    }
+    
+    if (line == ".stats") {
+        executor.print_session_stats(messages);
+        return true;
+    }
+    
+    if (line.compare(0, 6, ".mode ") == 0) {
+        OutputMode mode;
+        if (parse_output_mode(trim(line.substr(6)), mode)) {
+            executor.set_output_mode(mode);
+            return true;
+        }
+    }
+    
+    messages << "Unsupported command in batch mode: " << line << "\n";
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "../executor/executor.h"
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+
+// Runs a SQL script without prompts. A reader thread splits the script into
+// statements and parses them while the calling thread executes the ones
+// already parsed, so parsing overlaps with execution and output.
+class BatchRunner {
+public:
+    // Statements parsed ahead of execution before the reader waits.
+    static const size_t QUEUE_CAPACITY = 256;
+
+    explicit BatchRunner(Executor& executor);
+
+    // Executes every statement in script in order. SELECT rows go to
+    // results. Messages share results in table mode and go to diagnostics
+    // in the machine-readable modes, following any .mode in the script.
+    // Returns the number of statements that failed.
+    size_t run(std::istream& script, std::ostream& results, std::ostream& diagnostics);
+
+private:
+    struct Statement {
+        std::string sql;
+        ParsedCommand cmd;
+        double parse_seconds = 0;
+        bool shell_command = false;
+    };
+
+    Executor& executor;
+    Parser parser;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::condition_variable queue_space;
+    std::deque<Statement> queue;
+    bool reader_done = false;
+
+    void read_loop(std::istream& script);
+    void enqueue_statement(const std::string& text);
+    void enqueue_shell_command(const std::string& line);
+    void push(Statement statement);
+    bool pop(Statement& statement);
+    bool run_shell_command(const std::string& line, std::ostream& messages);
+};
+
+#endif // BATCH_RUNNER_H
\ No newline at end of file
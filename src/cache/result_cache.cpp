@@ -0,0 +1,81 @@
+#include "result_cache.h"
+
+// Bookkeeping per entry: list node, hash map node and the shared vector.
+static const size_t ENTRY_OVERHEAD = 128;
+
+void ResultCache::set_budget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budget_bytes = bytes;
+    evict_to(budget_bytes);
+}
+
+ResultCache::Rows ResultCache::lookup(const std::string& key, uint64_t version) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        counters.misses++;
+        return nullptr;
+    }
+    
+    if (it->second->version != version) {
+        erase(it->second);
+        counters.misses++;
+        return nullptr;
+    }
+    
+    lru.splice(lru.begin(), lru, it->second);
+    counters.hits++;
+    return it->second->rows;
+}
+
+void ResultCache::store(const std::string& key, uint64_t version, Rows rows) {
+    // Sized before taking the lock; it walks every row.
+    size_t bytes = estimate_bytes(key, *rows);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    auto existing = entries.find(key);
+    if (existing != entries.end()) {
+        erase(existing->second);
+    }
+    
+    // A result bigger than the whole budget would only flush everything else.
+    if (bytes > budget_bytes) return;
+    
+    evict_to(budget_bytes - bytes);
+    lru.push_front(Entry{key, version, std::move(rows), bytes});
+    entries[key] = lru.begin();
+    counters.entries++;
+    counters.bytes += bytes;
+}
+
+ResultCacheStats ResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void ResultCache::erase(std::list<Entry>::iterator entry) {
+    counters.entries--;
+    counters.bytes -= entry->bytes;
+    entries.erase(entry->key);
+    lru.erase(entry);
+}
+
+void ResultCache::evict_to(size_t limit) {
+    while (counters.bytes > limit && !lru.empty()) {
+        erase(std::prev(lru.end()));
+        counters.evictions++;
+    }
+}
+
+size_t ResultCache::estimate_bytes(const std::string& key, const std::vector<Row>& rows) {
+    size_t bytes = ENTRY_OVERHEAD + 2 * key.capacity() + rows.capacity() * sizeof(Row);
+    for (const Row& row : rows) {
+        bytes += row.values.capacity() * sizeof(Value);
+        for (const Value& val : row.values) {
+            if (std::holds_alternative<std::string>(val)) {
+                bytes += std::get<std::string>(val).capacity();
+            }
+        }
+    }
+    return bytes;
+}
\ No newline at end of file
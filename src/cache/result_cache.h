@@ -0,0 +1,57 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "../types.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct ResultCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// LRU cache of SELECT results within a memory budget. Each entry records the
+// version of the table it was read from. Writes bump that version, so a
+// lookup finds a stale entry, drops it and counts a miss. Stale entries that
+// are never looked up again age out like any other. Lookups and stores may
+// come from concurrent SELECTs; set_budget must not overlap them.
+class ResultCache {
+public:
+    using Rows = std::shared_ptr<const std::vector<Row>>;
+
+    // A budget of 0 disables the cache and frees every entry.
+    void set_budget(size_t bytes);
+    size_t budget() const { return budget_bytes; }
+    bool enabled() const { return budget_bytes > 0; }
+
+    // Returns the cached rows for key if they were read at this version.
+    Rows lookup(const std::string& key, uint64_t version);
+    void store(const std::string& key, uint64_t version, Rows rows);
+
+    ResultCacheStats stats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t version;
+        Rows rows;
+        size_t bytes;
+    };
+
+    mutable std::mutex mutex;
+    std::list<Entry> lru;   // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries;
+    size_t budget_bytes = 0;
+    ResultCacheStats counters;
+
+    void erase(std::list<Entry>::iterator entry);
+    void evict_to(size_t limit);
+    static size_t estimate_bytes(const std::string& key, const std::vector<Row>& rows);
+};
+
+#endif // RESULT_CACHE_H
\ No newline at end of file
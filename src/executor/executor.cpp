@@ -1,83 +1,646 @@
 #include "executor.h"
 #include <iostream>
+#include <iomanip>
 #include <regex>
+#include <charconv>
+#include <cctype>
+#include <cstring>
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string format_seconds(double seconds) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(6) << seconds;
+    return ss.str();
+}
+
+static std::string format_value(const Value& val) {
+    std::ostringstream ss;
+    if (std::holds_alternative<int64_t>(val)) {
+        ss << std::get<int64_t>(val);
+    } else if (std::holds_alternative<std::string>(val)) {
+        ss << "'" << std::get<std::string>(val) << "'";
+    } else if (std::holds_alternative<double>(val)) {
+        ss << std::get<double>(val);
+    }
+    return ss.str();
+}
+
+static bool is_word_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+}
+
+static bool is_operator_char(char c) {
+    return std::strchr("<>=!+-*/%", c) != nullptr;
+}
+
+// Identifies a SELECT for the result cache. A `column <op> literal` filter
+// is keyed by its column, operator and coerced value, so spacing and literal spelling do
+// not matter; other filters by their text with insignificant whitespace
+// removed. Fields are separated by \x1f, and the free-form part comes last.
+static std::string cache_key(const ParsedCommand& cmd) {
+    std::string key = cmd.table_name + '\x1f';
+    if (!cmd.has_where) {
+        return key + '*';
+    }
+    
+    if (!cmd.where_column.empty()) {
+        key += cmd.where_op + '\x1f' + cmd.where_column + '\x1f';
+        key += std::to_string(cmd.where_value.index()) + '\x1f';
+        const Value& val = cmd.where_value;
+        if (std::holds_alternative<int64_t>(val)) {
+            key += std::to_string(std::get<int64_t>(val));
+        } else if (std::holds_alternative<double>(val)) {
+            char digits[32];
+            auto result = std::to_chars(digits, digits + sizeof(digits), std::get<double>(val));
+            key.append(digits, result.ptr);
+        } else {
+            key += std::get<std::string>(val);
+        }
+        return key;
+    }
+    
+    // Whitespace matters only between two word characters (`NOT active`) or
+    // two operator characters (`< =` is not `<=`); elsewhere it is dropped.
+    key += "?\x1f";
+    bool in_quote = false;
+    bool pending_space = false;
+    for (char c : cmd.where_expr) {
+        if (!in_quote && std::isspace(static_cast<unsigned char>(c))) {
+            pending_space = true;
+            continue;
+        }
+        char prev = key.back();
+        if (pending_space && ((is_word_char(c) && is_word_char(prev)) ||
+                              (is_operator_char(c) && is_operator_char(prev)))) {
+            key += ' ';
+        }
+        pending_space = false;
+        if (c == '\'') in_quote = !in_quote;
+        key += c;
+    }
+    return key;
+}
+
+// How often the maintenance thread looks for stale stats and sparse tables.
+static const std::chrono::seconds MAINTENANCE_INTERVAL(1);
 
 Executor::Executor(const std::string& db_file) : storage(db_file) {
+    maintenance = std::thread(&Executor::maintenance_loop, this);
+}
+
+Executor::~Executor() {
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        stop_maintenance = true;
+    }
+    maintenance_wakeup.notify_all();
+    maintenance.join();
+}
+
+void Executor::set_auto_vacuum(bool enabled) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto_vacuum = enabled;
+}
+
+void Executor::set_result_cache(size_t budget_bytes) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    cache.set_budget(budget_bytes);
+}
+
+void Executor::maintenance_loop() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    while (!stop_maintenance) {
+        maintenance_wakeup.wait_for(lock, MAINTENANCE_INTERVAL);
+        if (stop_maintenance) break;
+        
+        refresh_stale_stats();
+        if (auto_vacuum) {
+            storage.compact_sparse_tables();
+        }
+    }
+}
+
+// Re-analyzing sorts every column, so it happens here rather than inside
+// the statement that crossed the threshold. Until then the planner works
+// from the old histograms, whose row count and min/max are kept current.
+void Executor::refresh_stale_stats() {
+    for (const std::string& name : storage.table_names()) {
+        Table* table = storage.get_table(name);
+        if (table && Planner::needs_analyze(*table)) {
+            storage.analyze(name);
+        }
+    }
 }
 
-bool Executor::execute_command(const std::string& sql) {
+bool Executor::execute_command(const std::string& sql, std::ostream& out) {
+    // Parsing touches no shared state, so concurrent callers only queue up
+    // for the part that reads or writes tables.
+    auto parse_start = Clock::now();
     ParsedCommand cmd = parser.parse_command(sql);
+    double parse_seconds = seconds_since(parse_start);
     
+    return execute_parsed(cmd, sql, parse_seconds, out, out);
+}
+
+bool Executor::execute_parsed(ParsedCommand& cmd, const std::string& sql, double parse_seconds,
+                              std::ostream& results, std::ostream& messages) {
+    Context ctx{messages, results, QueryProfile()};
+    
+    // SELECTs only read tables, so they run side by side under a shared
+    // lock. Anything that writes, including a lookup that would rebuild a
+    // stale index, takes it exclusively.
+    if (cmd.type == SQLCommandType::SELECT) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (can_run_shared(cmd)) {
+            return run_command(ctx, cmd, sql, parse_seconds);
+        }
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    storage.set_output(messages);
+    
+    bool success = false;
+    try {
+        success = run_command(ctx, cmd, sql, parse_seconds);
+    } catch (...) {
+        storage.set_output(std::cout);
+        throw;
+    }
+    
+    storage.set_output(std::cout);
+    return success;
+}
+
+// Storage only writes messages for a missing table, and only rebuilds an
+// index that a write left stale; with neither, a SELECT is read-only.
+bool Executor::can_run_shared(const ParsedCommand& cmd) const {
+    const Table* table = storage.get_table(cmd.table_name);
+    if (!table) return false;
+    
+    for (const Index& index : table->indexes) {
+        if (index.stale) return false;
+    }
+    return true;
+}
+
+bool Executor::run_command(Context& ctx, ParsedCommand& cmd, const std::string& sql, double parse_seconds) {
+    ctx.profile.parse_seconds = parse_seconds;
+    normalize_where(cmd);
+    
+    if (cmd.explain == ExplainMode::QUERY_PLAN) {
+        print_query_plan(ctx, cmd);
+        return cmd.type != SQLCommandType::INVALID;
+    }
+    
+    // Expression errors found while running (division by zero, overflow)
+    // fail the statement; writes evaluate every row before changing any.
+    auto execute_start = Clock::now();
+    bool success = false;
+    try {
+        success = dispatch(ctx, cmd, sql);
+    } catch (const std::runtime_error& e) {
+        ctx.output << "Error: " << e.what() << "\n";
+    }
+    ctx.profile.execute_seconds = seconds_since(execute_start) - ctx.profile.output_seconds;
+    
+    const Table* table = storage.get_table(cmd.table_name);
+    if (table && Planner::needs_analyze(*table)) {
+        maintenance_wakeup.notify_one();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(session_mutex);
+        session.statements++;
+        if (!success) session.failed++;
+        session.parse_seconds += ctx.profile.parse_seconds;
+        session.execute_seconds += ctx.profile.execute_seconds;
+        session.output_seconds += ctx.profile.output_seconds;
+    }
+    
+    if (cmd.explain == ExplainMode::ANALYZE) {
+        print_analyze(ctx);
+    }
+    if (timer_enabled) {
+        print_timer(ctx);
+    }
+    return success;
+}
+
+bool Executor::dispatch(Context& ctx, const ParsedCommand& cmd, const std::string& original_sql) {
     switch (cmd.type) {
         case SQLCommandType::CREATE_TABLE:
-            return execute_create_table(cmd, sql);
+            return execute_create_table(ctx, cmd, original_sql);
+        case SQLCommandType::CREATE_INDEX:
+            return execute_create_index(ctx, cmd);
+        case SQLCommandType::ANALYZE:
+            return execute_analyze(ctx, cmd);
+        case SQLCommandType::VACUUM:
+            return execute_vacuum(ctx, cmd);
         case SQLCommandType::INSERT:
-            return execute_insert(cmd);
+            return execute_insert(ctx, cmd);
         case SQLCommandType::SELECT:
-            return execute_select(cmd);
+            return execute_select(ctx, cmd);
         case SQLCommandType::UPDATE:
-            return execute_update(cmd);
+            return execute_update(ctx, cmd);
         case SQLCommandType::DELETE:
-            return execute_delete(cmd);
+            return execute_delete(ctx, cmd);
         case SQLCommandType::INVALID:
-            std::cout << "Invalid SQL command\n";
+            ctx.output << "Invalid SQL command\n";
             return false;
     }
     return false;
 }
 
-bool Executor::execute_create_table(const ParsedCommand& cmd, const std::string& original_sql) {
+bool Executor::execute_create_table(Context& ctx, const ParsedCommand& cmd, const std::string& original_sql) {
+    auto start = Clock::now();
     std::vector<Column> columns = parse_create_table_columns(original_sql);
-    return storage.create_table(cmd.table_name, columns);
+    bool success = storage.create_table(cmd.table_name, columns);
+    record_operator(ctx, describe_plan(cmd).front(), ScanStats(), start);
+    return success;
+}
+
+bool Executor::execute_create_index(Context& ctx, const ParsedCommand& cmd) {
+    auto start = Clock::now();
+    bool success = storage.create_index(cmd.index_name, cmd.table_name, cmd.column_names[0]);
+    record_operator(ctx, describe_plan(cmd).front(), ScanStats(), start);
+    return success;
+}
+
+bool Executor::execute_analyze(Context& ctx, const ParsedCommand& cmd) {
+    std::vector<std::string> names;
+    if (cmd.table_name.empty()) {
+        names = storage.table_names();
+    } else {
+        names.push_back(cmd.table_name);
+    }
+    
+    auto start = Clock::now();
+    ScanStats scan;
+    for (const std::string& name : names) {
+        if (!storage.analyze(name)) {
+            return false;
+        }
+        const Table* table = storage.get_table(name);
+        scan.rows_scanned += table->live_row_count();
+        print_table_stats(ctx, *table);
+    }
+    record_operator(ctx, describe_plan(cmd).front(), scan, start);
+    return true;
+}
+
+bool Executor::execute_vacuum(Context& ctx, const ParsedCommand& cmd) {
+    std::vector<std::string> names;
+    if (cmd.table_name.empty()) {
+        names = storage.table_names();
+    } else {
+        names.push_back(cmd.table_name);
+    }
+    
+    auto start = Clock::now();
+    for (const std::string& name : names) {
+        if (!storage.vacuum(name)) {
+            return false;
+        }
+    }
+    
+    // Rewriting the file drops the space the deleted rows held.
+    storage.save_to_file();
+    record_operator(ctx, describe_plan(cmd).front(), ScanStats(), start);
+    ctx.output << "Vacuumed " << names.size() << " table(s)\n";
+    return true;
 }
 
-bool Executor::execute_insert(const ParsedCommand& cmd) {
+bool Executor::execute_insert(Context& ctx, const ParsedCommand& cmd) {
+    auto start = Clock::now();
     Row row;
     row.values = cmd.values;
-    return storage.insert_row(cmd.table_name, row);
+    bool success = storage.insert_row(cmd.table_name, row);
+    
+    ScanStats scan;
+    scan.rows_matched = success ? 1 : 0;
+    record_operator(ctx, describe_plan(cmd).front(), scan, start);
+    return success;
 }
 
-bool Executor::execute_select(const ParsedCommand& cmd) {
-    std::vector<Row> results;
+bool Executor::execute_select(Context& ctx, const ParsedCommand& cmd) {
+    ResultCache::Rows results;
+    ScanStats scan;
+    auto start = Clock::now();
+    
+    const Table* table = storage.get_table(cmd.table_name);
+    if (!table) {
+        ctx.output << "Table '" << cmd.table_name << "' does not exist\n";
+        return false;
+    }
     
-    if (cmd.has_where) {
-        results = storage.select_where(cmd.table_name, cmd.where_column, cmd.where_value);
+    // A hit skips compiling, planning and scanning altogether.
+    std::string key;
+    if (cache.enabled()) {
+        key = cache_key(cmd);
+        results = cache.lookup(key, table->version);
+    }
+    
+    if (results) {
+        scan.rows_matched = results->size();
+        record_operator(ctx, "RESULT CACHE HIT", scan, start);
     } else {
-        results = storage.select_all(cmd.table_name);
+        Program where;
+        if (cmd.has_where && !compile_where(ctx, cmd, *table, where)) {
+            return false;
+        }
+        
+        std::vector<Row> rows;
+        QueryPlan plan = plan_access(cmd);
+        switch (plan.path) {
+            case AccessPath::NO_MATCH:
+                break;
+            case AccessPath::INDEX_LOOKUP:
+            case AccessPath::RANGE_SCAN: {
+                IndexProbe probe;
+                probe.index_name = plan.index_name;
+                probe.op = cmd.where_op;
+                probe.key = cmd.where_value;
+                rows = storage.index_lookup(cmd.table_name, probe, &scan);
+                break;
+            }
+            case AccessPath::FULL_SCAN:
+                if (cmd.has_where) {
+                    rows = storage.select_where(cmd.table_name, where, &scan);
+                } else {
+                    rows = storage.select_all(cmd.table_name, &scan);
+                }
+                break;
+        }
+        record_operator(ctx, planner.describe(cmd, plan), scan, start);
+        
+        results = std::make_shared<const std::vector<Row>>(std::move(rows));
+        if (!key.empty()) {
+            cache.store(key, table->version, results);
+        }
     }
     
-    if (results.empty()) {
-        std::cout << "No rows found\n";
+    // Machine-readable modes still emit an empty result set so consumers
+    // see one per SELECT. EXPLAIN ANALYZE prints only the profile, which
+    // keeps its OUTPUT operator even when nothing matched.
+    if (results->empty() && mode == OutputMode::TABLE && cmd.explain != ExplainMode::ANALYZE) {
+        ctx.output << "No rows found\n";
         return true;
     }
     
-    storage.print_table(cmd.table_name);
+    // EXPLAIN ANALYZE still formats the rows so the output cost is measured, but discards them.
+    std::ostringstream discarded;
+    std::ostream& out = cmd.explain == ExplainMode::ANALYZE ? discarded : ctx.results;
+    
+    auto output_start = Clock::now();
+    storage.print_rows(cmd.table_name, *results, out, mode);
+    ctx.profile.output_seconds = seconds_since(output_start);
+    
+    OperatorStats output;
+    output.name = "OUTPUT";
+    output.rows_in = results->size();
+    output.rows_out = results->size();
+    output.seconds = ctx.profile.output_seconds;
+    ctx.profile.operators.push_back(output);
     return true;
 }
 
-bool Executor::execute_update(const ParsedCommand& cmd) {
-    if (!cmd.has_where || cmd.column_names.empty() || cmd.values.empty()) {
-        std::cout << "Invalid UPDATE command\n";
+bool Executor::execute_update(Context& ctx, const ParsedCommand& cmd) {
+    if (!cmd.has_where || cmd.column_names.empty()) {
+        ctx.output << "Invalid UPDATE command\n";
+        return false;
+    }
+    
+    Table* table = storage.get_table(cmd.table_name);
+    if (!table) {
+        ctx.output << "Table '" << cmd.table_name << "' does not exist\n";
         return false;
     }
     
-    return storage.update_rows(cmd.table_name, cmd.column_names[0], cmd.values[0],
-                              cmd.where_column, cmd.where_value);
+    Program where;
+    if (!compile_where(ctx, cmd, *table, where)) {
+        return false;
+    }
+    
+    std::vector<Assignment> assignments;
+    try {
+        Compiler compiler(*table);
+        for (size_t i = 0; i < cmd.column_names.size(); ++i) {
+            auto column = std::find_if(table->columns.begin(), table->columns.end(),
+                [&cmd, i](const Column& col) { return col.name == cmd.column_names[i]; });
+            if (column == table->columns.end()) {
+                ctx.output << "Column '" << cmd.column_names[i] << "' not found\n";
+                return false;
+            }
+            
+            Assignment assignment;
+            assignment.column_index = column - table->columns.begin();
+            assignment.value = compiler.compile_value(cmd.set_exprs[i], column->type);
+            assignments.push_back(assignment);
+        }
+    } catch (const std::runtime_error& e) {
+        ctx.output << e.what() << "\n";
+        return false;
+    }
+    
+    ScanStats scan;
+    auto start = Clock::now();
+    bool success = storage.update_rows(cmd.table_name, assignments, where, &scan);
+    record_operator(ctx, describe_plan(cmd).front(), scan, start);
+    return success;
 }
 
-bool Executor::execute_delete(const ParsedCommand& cmd) {
+bool Executor::execute_delete(Context& ctx, const ParsedCommand& cmd) {
     if (!cmd.has_where) {
-        std::cout << "DELETE without WHERE clause not supported\n";
+        ctx.output << "DELETE without WHERE clause not supported\n";
+        return false;
+    }
+    
+    Table* table = storage.get_table(cmd.table_name);
+    if (!table) {
+        ctx.output << "Table '" << cmd.table_name << "' does not exist\n";
+        return false;
+    }
+    
+    Program where;
+    if (!compile_where(ctx, cmd, *table, where)) {
         return false;
     }
     
-    return storage.delete_rows(cmd.table_name, cmd.where_column, cmd.where_value);
+    ScanStats scan;
+    auto start = Clock::now();
+    bool success = true;
+    
+    QueryPlan plan = plan_access(cmd);
+    switch (plan.path) {
+        case AccessPath::NO_MATCH:
+            ctx.output << "Deleted 0 rows\n";
+            break;
+        case AccessPath::INDEX_LOOKUP:
+        case AccessPath::RANGE_SCAN: {
+            IndexProbe probe;
+            probe.index_name = plan.index_name;
+            probe.op = cmd.where_op;
+            probe.key = cmd.where_value;
+            success = storage.delete_rows(cmd.table_name, where, &probe, &scan);
+            break;
+        }
+        case AccessPath::FULL_SCAN:
+            success = storage.delete_rows(cmd.table_name, where, nullptr, &scan);
+            break;
+    }
+    record_operator(ctx, planner.describe(cmd, plan), scan, start);
+    return success;
+}
+
+// Brings a decomposed `column <op> literal` to the column's storage type so
+// index lookups and min/max checks compare like with like. If it cannot be
+// converted the planner ignores it and the compiler reports the mismatch.
+void Executor::normalize_where(ParsedCommand& cmd) const {
+    const Table* table = storage.get_table(cmd.table_name);
+    if (!table || cmd.where_column.empty()) return;
+    
+    for (const Column& col : table->columns) {
+        if (col.name == cmd.where_column && !Storage::coerce_value(cmd.where_value, col.type)) {
+            cmd.where_column.clear();
+        }
+    }
+}
+
+bool Executor::compile_where(Context& ctx, const ParsedCommand& cmd, const Table& table, Program& where) {
+    try {
+        where = Compiler(table).compile_predicate(cmd.where_expr);
+    } catch (const std::runtime_error& e) {
+        ctx.output << e.what() << "\n";
+        return false;
+    }
+    return true;
+}
+
+QueryPlan Executor::plan_access(const ParsedCommand& cmd) const {
+    const Table* table = storage.get_table(cmd.table_name);
+    if (!table) {
+        return QueryPlan();
+    }
+    return planner.plan_access(cmd, *table);
+}
+
+std::vector<std::string> Executor::describe_plan(const ParsedCommand& cmd) const {
+    std::string filter = Planner::describe_filter(cmd);
+    
+    switch (cmd.type) {
+        case SQLCommandType::CREATE_TABLE:
+            return {"CREATE TABLE " + cmd.table_name};
+        case SQLCommandType::CREATE_INDEX:
+            return {"CREATE INDEX " + cmd.index_name + " ON " + cmd.table_name};
+        case SQLCommandType::ANALYZE:
+            return {"ANALYZE" + (cmd.table_name.empty() ? "" : " " + cmd.table_name)};
+        case SQLCommandType::VACUUM:
+            return {"VACUUM" + (cmd.table_name.empty() ? "" : " " + cmd.table_name)};
+        case SQLCommandType::INSERT:
+            return {"INSERT INTO " + cmd.table_name};
+        case SQLCommandType::SELECT:
+            return {planner.describe(cmd, plan_access(cmd)), "OUTPUT"};
+        case SQLCommandType::UPDATE: {
+            std::string targets;
+            for (const std::string& column : cmd.column_names) {
+                targets += (targets.empty() ? " SET " : ", ") + column;
+            }
+            return {"UPDATE " + cmd.table_name + targets + filter};
+        }
+        case SQLCommandType::DELETE:
+            return {planner.describe(cmd, plan_access(cmd))};
+        case SQLCommandType::INVALID:
+            break;
+    }
+    return {};
+}
+
+void Executor::record_operator(Context& ctx, const std::string& name, const ScanStats& scan, Clock::time_point start) {
+    OperatorStats op;
+    op.name = name;
+    op.rows_in = scan.rows_scanned;
+    op.rows_out = scan.rows_matched;
+    op.bytes_read = scan.bytes_read;
+    op.seconds = seconds_since(start);
+    ctx.profile.operators.push_back(op);
+    
+    std::lock_guard<std::mutex> lock(session_mutex);
+    session.rows_scanned += scan.rows_scanned;
+    session.rows_matched += scan.rows_matched;
+    session.bytes_read += scan.bytes_read;
+}
+
+void Executor::print_query_plan(Context& ctx, const ParsedCommand& cmd) const {
+    std::vector<std::string> plan = describe_plan(cmd);
+    if (plan.empty()) {
+        ctx.output << "Invalid SQL command\n";
+        return;
+    }
+    
+    ctx.output << "QUERY PLAN\n";
+    for (size_t i = 0; i < plan.size(); ++i) {
+        ctx.output << (i + 1 == plan.size() ? "`--" : "|--") << plan[i] << "\n";
+    }
+}
+
+void Executor::print_analyze(Context& ctx) const {
+    if (ctx.profile.operators.empty()) return;
+    
+    ctx.output << "QUERY PLAN\n";
+    for (size_t i = 0; i < ctx.profile.operators.size(); ++i) {
+        const OperatorStats& op = ctx.profile.operators[i];
+        ctx.output << (i + 1 == ctx.profile.operators.size() ? "`--" : "|--") << op.name
+                  << " (rows in=" << op.rows_in
+                  << ", rows out=" << op.rows_out
+                  << ", bytes read=" << op.bytes_read
+                  << ", time=" << format_seconds(op.seconds) << "s)\n";
+    }
+}
+
+void Executor::print_table_stats(Context& ctx, const Table& table) const {
+    ctx.output << "Analyzed '" << table.name << "': " << table.stats.row_count << " rows\n";
+    for (size_t i = 0; i < table.columns.size(); ++i) {
+        const ColumnStats& col = table.stats.columns[i];
+        ctx.output << "  " << table.columns[i].name << ": " << col.distinct_count << " distinct";
+        if (col.has_range) {
+            ctx.output << ", min " << format_value(col.min) << ", max " << format_value(col.max);
+        }
+        ctx.output << ", " << col.histogram.size() << " histogram buckets\n";
+    }
+}
+
+void Executor::print_timer(Context& ctx) const {
+    ctx.output << "Run Time: parse " << format_seconds(ctx.profile.parse_seconds)
+              << " execute " << format_seconds(ctx.profile.execute_seconds)
+              << " output " << format_seconds(ctx.profile.output_seconds) << "\n";
+}
+
+void Executor::print_session_stats(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(session_mutex);
+    out << "Statements executed:  " << session.statements << " (" << session.failed << " failed)\n";
+    out << "Rows scanned:         " << session.rows_scanned << "\n";
+    out << "Rows matched:         " << session.rows_matched << "\n";
+    out << "Bytes read:           " << session.bytes_read << "\n";
+    out << "Parse time:           " << format_seconds(session.parse_seconds) << "s\n";
+    out << "Execute time:         " << format_seconds(session.execute_seconds) << "s\n";
+    out << "Output time:          " << format_seconds(session.output_seconds) << "s\n";
+    
+    if (cache.enabled()) {
+        ResultCacheStats stats = cache.stats();
+        out << "Result cache:         " << stats.hits << " hits, " << stats.misses << " misses, "
+            << stats.evictions << " evictions\n";
+        out << "Result cache memory:  " << stats.bytes << " of " << cache.budget() << " bytes in "
+            << stats.entries << " entries\n";
+    }
 }
 
 std::vector<Column> Executor::parse_create_table_columns(const std::string& sql) {
     std::vector<Column> columns;
     
-    std::regex create_regex(R"(CREATE TABLE\s+\w+\s*\(([^)]+)\))", std::regex_constants::icase);
+    static const std::regex create_regex(R"(CREATE TABLE\s+\w+\s*\(([^)]+)\))", std::regex_constants::icase);
     std::smatch matches;
     
     if (std::regex_search(sql, matches, create_regex)) {
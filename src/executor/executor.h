@@ -4,24 +4,123 @@
 #include "../types.h"
 #include "../storage/storage.h"
 #include "../parser/parser.h"
+#include "../planner/planner.h"
+#include "../vm/compiler.h"
+#include "../cache/result_cache.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+// One step of an executed plan, as reported by EXPLAIN ANALYZE.
+struct OperatorStats {
+    std::string name;
+    size_t rows_in = 0;
+    size_t rows_out = 0;
+    size_t bytes_read = 0;
+    double seconds = 0;
+};
+
+// Timings and operators for the statement currently being executed.
+struct QueryProfile {
+    double parse_seconds = 0;
+    double execute_seconds = 0;
+    double output_seconds = 0;
+    std::vector<OperatorStats> operators;
+};
+
+// Totals accumulated over every statement run in this session.
+struct SessionStats {
+    size_t statements = 0;
+    size_t failed = 0;
+    size_t rows_scanned = 0;
+    size_t rows_matched = 0;
+    size_t bytes_read = 0;
+    double parse_seconds = 0;
+    double execute_seconds = 0;
+    double output_seconds = 0;
+};
 
 class Executor {
 private:
+    using Clock = std::chrono::steady_clock;
+
     Storage storage;
     Parser parser;
+    Planner planner;
+    ResultCache cache;
+    bool timer_enabled = false;
+    OutputMode mode = OutputMode::TABLE;
+    
+    mutable std::mutex session_mutex;
+    SessionStats session;
+    
+    // Held shared by read-only SELECTs and exclusively by every other
+    // statement and by the background maintenance thread, which refreshes
+    // stale statistics and, with auto-vacuum on, compacts tables.
+    mutable std::shared_mutex mutex;
+    std::thread maintenance;
+    std::condition_variable_any maintenance_wakeup;
+    bool stop_maintenance = false;
+    bool auto_vacuum = false;
 
 public:
     Executor(const std::string& db_file = "database.db");
-    ~Executor() = default;
+    ~Executor();
 
-    bool execute_command(const std::string& sql);
+    // Runs one statement, writing its results and messages to out. Safe to
+    // call from several threads: SELECTs run concurrently with each other,
+    // any other statement runs alone.
+    bool execute_command(const std::string& sql, std::ostream& out = std::cout);
+    
+    // Runs a statement that was already parsed, e.g. on another thread.
+    // SELECT rows go to results; everything else goes to messages.
+    bool execute_parsed(ParsedCommand& cmd, const std::string& sql, double parse_seconds,
+                        std::ostream& results, std::ostream& messages);
+    
+    void set_timer(bool enabled) { timer_enabled = enabled; }
+    void set_output_mode(OutputMode new_mode) { mode = new_mode; }
+    OutputMode output_mode() const { return mode; }
+    void set_auto_vacuum(bool enabled);
+    
+    // Caches SELECT results in up to budget_bytes of memory; 0 turns it off.
+    void set_result_cache(size_t budget_bytes);
+    void print_session_stats(std::ostream& out = std::cout) const;
     
 private:
-    bool execute_create_table(const ParsedCommand& cmd, const std::string& original_sql);
-    bool execute_insert(const ParsedCommand& cmd);
-    bool execute_select(const ParsedCommand& cmd);
-    bool execute_update(const ParsedCommand& cmd);
-    bool execute_delete(const ParsedCommand& cmd);
+    // What one statement writes while it runs. Concurrent SELECTs each have
+    // their own, so none of it lives in the Executor.
+    struct Context {
+        std::ostream& output;     // messages
+        std::ostream& results;    // SELECT rows
+        QueryProfile profile;
+    };
+
+    bool can_run_shared(const ParsedCommand& cmd) const;
+    bool run_command(Context& ctx, ParsedCommand& cmd, const std::string& sql, double parse_seconds);
+    bool dispatch(Context& ctx, const ParsedCommand& cmd, const std::string& original_sql);
+    bool execute_create_table(Context& ctx, const ParsedCommand& cmd, const std::string& original_sql);
+    bool execute_create_index(Context& ctx, const ParsedCommand& cmd);
+    bool execute_analyze(Context& ctx, const ParsedCommand& cmd);
+    bool execute_vacuum(Context& ctx, const ParsedCommand& cmd);
+    bool execute_insert(Context& ctx, const ParsedCommand& cmd);
+    bool execute_select(Context& ctx, const ParsedCommand& cmd);
+    bool execute_update(Context& ctx, const ParsedCommand& cmd);
+    bool execute_delete(Context& ctx, const ParsedCommand& cmd);
+    
+    void normalize_where(ParsedCommand& cmd) const;
+    bool compile_where(Context& ctx, const ParsedCommand& cmd, const Table& table, Program& where);
+    QueryPlan plan_access(const ParsedCommand& cmd) const;
+    std::vector<std::string> describe_plan(const ParsedCommand& cmd) const;
+    void record_operator(Context& ctx, const std::string& name, const ScanStats& scan, Clock::time_point start);
+    void print_query_plan(Context& ctx, const ParsedCommand& cmd) const;
+    void print_table_stats(Context& ctx, const Table& table) const;
+    void print_analyze(Context& ctx) const;
+    void print_timer(Context& ctx) const;
+    
+    void maintenance_loop();
+    void refresh_stale_stats();
     
     std::vector<Column> parse_create_table_columns(const std::string& sql);
 };
@@ -1,6 +1,22 @@
 #include <iostream>
 #include <string>
+#include <thread>
+#include <fstream>
+#include <csignal>
+#include <cstdint>
+#include <unistd.h>
 #include "executor/executor.h"
+#include "server/server.h"
+#include "batch/batch_runner.h"
+#include "output/buffered_writer.h"
+
+static Server* active_server = nullptr;
+
+static void handle_stop_signal(int) {
+    if (active_server) {
+        active_server->stop();
+    }
+}
 
 void print_welcome() {
     std::cout << "=================================\n";
@@ -14,25 +30,110 @@ void print_help() {
     std::cout << "\nAvailable commands:\n";
     std::cout << "  CREATE TABLE table_name (column1 TYPE, column2 TYPE, ...);\n";
     std::cout << "  INSERT INTO table_name VALUES (value1, value2, ...);\n";
-    std::cout << "  SELECT * FROM table_name [WHERE column = value];\n";
-    std::cout << "  UPDATE table_name SET column = value WHERE column = value;\n";
-    std::cout << "  DELETE FROM table_name WHERE column = value;\n";
-    std::cout << "\nSupported data types: INTEGER, TEXT, REAL\n";
+    std::cout << "  SELECT * FROM table_name [WHERE condition];\n";
+    std::cout << "  UPDATE table_name SET column = expr[, column = expr ...] WHERE condition;\n";
+    std::cout << "  DELETE FROM table_name WHERE condition;\n";
+    std::cout << "  CREATE INDEX index_name ON table_name (column);\n";
+    std::cout << "  ANALYZE [table_name];\n";
+    std::cout << "  VACUUM [table_name];\n";
+    std::cout << "  EXPLAIN [QUERY PLAN | ANALYZE] statement;\n";
+    std::cout << "\nShell commands:\n";
+    std::cout << "  .timer on|off    Show parse/execute/output time after each statement\n";
+    std::cout << "  .stats           Show cumulative statistics for this session\n";
+    std::cout << "  .autovacuum on|off  Compact tables with many deleted rows in the background\n";
+    std::cout << "  .mode table|csv|json|binary  Format of SELECT results\n";
+    std::cout << "  .cache MB        Cache SELECT results in up to MB megabytes (0 turns it off)\n";
+    std::cout << "\nConditions and expressions support + - * / %, = <> < <= > >=, AND, OR, NOT\n";
+    std::cout << "Supported data types: INTEGER, TEXT, REAL\n";
     std::cout << "Example:\n";
     std::cout << "  CREATE TABLE users (id INTEGER, name TEXT, age INTEGER);\n";
     std::cout << "  INSERT INTO users VALUES (1, 'Alice', 25);\n";
     std::cout << "  SELECT * FROM users WHERE id = 1;\n\n";
 }
 
-int main() {
+void print_usage() {
+    std::cout << "Usage: mini_sqlite [DB_FILE] [-f SCRIPT] [--mode MODE] [--serve SOCKET_PATH] [--workers N] [--cache MB]\n";
+    std::cout << "  DB_FILE              Database file (default: mini_sqlite.db)\n";
+    std::cout << "  -f SCRIPT            Run the statements in SCRIPT ('-' for stdin) and exit\n";
+    std::cout << "  --mode MODE          SELECT output format: table, csv, json or binary (default: table)\n";
+    std::cout << "  --serve SOCKET_PATH  Serve clients on a Unix domain socket instead of the REPL\n";
+    std::cout << "  --workers N          Statement worker threads in server mode (default: CPU count)\n";
+    std::cout << "  --cache MB           Cache SELECT results in up to MB megabytes (default: off)\n";
+}
+
+static const size_t BYTES_PER_MB = 1024 * 1024;
+static const size_t MAX_CACHE_MB = SIZE_MAX / BYTES_PER_MB;
+static const size_t MAX_WORKERS = 1024;
+
+// Parses a plain decimal count no larger than max. Unlike std::stoul this
+// rejects signs, trailing text and overflow instead of throwing or wrapping.
+static bool parse_count(const std::string& text, size_t max, size_t& value) {
+    if (text.empty() || text.size() > 20) return false;
+
+    unsigned long long parsed = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        parsed = parsed * 10 + (c - '0');
+        if (parsed > max) return false;
+    }
+    value = parsed;
+    return true;
+}
+
+int run_server(const std::string& db_file, const std::string& socket_path, size_t workers, size_t cache_mb) {
+    Executor executor(db_file);
+    executor.set_result_cache(cache_mb * BYTES_PER_MB);
+    Server server(executor, socket_path, workers);
+    
+    active_server = &server;
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+    
+    bool ok = server.run();
+    active_server = nullptr;
+    return ok ? 0 : 1;
+}
+
+// Results go to stdout through a large buffer. In table mode messages share
+// that stream so they stay in order with the rows; the machine-readable modes
+// send them to stderr to keep stdout parseable. BatchRunner makes that choice
+// per statement, so a .mode in the script takes effect too.
+int run_batch(const std::string& db_file, const std::string& script_path, OutputMode mode, size_t cache_mb) {
+    std::ifstream file;
+    if (script_path != "-") {
+        file.open(script_path);
+        if (!file) {
+            std::cerr << "Cannot open script '" << script_path << "'\n";
+            return 1;
+        }
+    }
+    std::istream& script = script_path == "-" ? std::cin : file;
+    
+    Executor executor(db_file);
+    executor.set_output_mode(mode);
+    executor.set_result_cache(cache_mb * BYTES_PER_MB);
+    
+    BufferedWriter writer(STDOUT_FILENO);
+    std::ostream results(&writer);
+    
+    BatchRunner runner(executor);
+    size_t failed = runner.run(script, results, std::cerr);
+    results.flush();
+    return failed == 0 ? 0 : 1;
+}
+
+int run_repl(const std::string& db_file, OutputMode mode, size_t cache_mb) {
     print_welcome();
     
-    Executor executor("mini_sqlite.db");
+    Executor executor(db_file);
+    executor.set_output_mode(mode);
+    executor.set_result_cache(cache_mb * BYTES_PER_MB);
     std::string input;
     
     while (true) {
         std::cout << "sqlite> ";
-        std::getline(std::cin, input);
+        if (!std::getline(std::cin, input)) break;
         
         if (input.empty()) continue;
         
@@ -46,6 +147,40 @@ int main() {
             continue;
         }
         
+        if (input == ".timer on" || input == ".timer off") {
+            executor.set_timer(input == ".timer on");
+            continue;
+        }
+        
+        if (input == ".autovacuum on" || input == ".autovacuum off") {
+            executor.set_auto_vacuum(input == ".autovacuum on");
+            continue;
+        }
+        
+        if (input.compare(0, 6, ".mode ") == 0) {
+            if (parse_output_mode(input.substr(6), mode)) {
+                executor.set_output_mode(mode);
+            } else {
+                std::cout << "Unknown mode: " << input.substr(6) << "\n";
+            }
+            continue;
+        }
+        
+        if (input.compare(0, 7, ".cache ") == 0) {
+            size_t megabytes = 0;
+            if (parse_count(input.substr(7), MAX_CACHE_MB, megabytes)) {
+                executor.set_result_cache(megabytes * BYTES_PER_MB);
+            } else {
+                std::cout << "Usage: .cache MB\n";
+            }
+            continue;
+        }
+        
+        if (input == ".stats") {
+            executor.print_session_stats();
+            continue;
+        }
+        
         if (input.back() != ';') {
             input += ';';
         }
@@ -60,4 +195,54 @@ int main() {
     }
     
     return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string db_file = "mini_sqlite.db";
+    std::string socket_path;
+    std::string script_path;
+    OutputMode mode = OutputMode::TABLE;
+    size_t workers = std::thread::hardware_concurrency();
+    size_t cache_mb = 0;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        
+        if (arg == "--serve" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (arg == "-f" && i + 1 < argc) {
+            script_path = argv[++i];
+        } else if (arg == "--mode" && i + 1 < argc) {
+            if (!parse_output_mode(argv[++i], mode)) {
+                print_usage();
+                return 1;
+            }
+        } else if (arg == "--workers" && i + 1 < argc) {
+            if (!parse_count(argv[++i], MAX_WORKERS, workers)) {
+                print_usage();
+                return 1;
+            }
+        } else if (arg == "--cache" && i + 1 < argc) {
+            if (!parse_count(argv[++i], MAX_CACHE_MB, cache_mb)) {
+                print_usage();
+                return 1;
+            }
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            return 0;
+        } else if (arg[0] != '-') {
+            db_file = arg;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    
+    if (!socket_path.empty()) {
+        return run_server(db_file, socket_path, workers, cache_mb);
+    }
+    if (!script_path.empty()) {
+        return run_batch(db_file, script_path, mode, cache_mb);
+    }
+    return run_repl(db_file, mode, cache_mb);
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "buffered_writer.h"
+#include <cerrno>
+#include <unistd.h>
+
+BufferedWriter::BufferedWriter(int fd, size_t capacity) : fd(fd), buffer(capacity) {
+    setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+BufferedWriter::~BufferedWriter() {
+    flush_buffer();
+}
+
+BufferedWriter::int_type BufferedWriter::overflow(int_type ch) {
+    if (!flush_buffer()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize BufferedWriter::xsputn(const char* data, std::streamsize count) {
+    size_t size = static_cast<size_t>(count);
+    size_t room = static_cast<size_t>(epptr() - pptr());
+    if (size <= room) {
+        traits_type::copy(pptr(), data, size);
+        pbump(static_cast<int>(size));
+        return count;
+    }
+    
+    // Chunks bigger than the buffer skip the copy and go straight out.
+    if (!flush_buffer()) {
+        return 0;
+    }
+    if (size >= buffer.size()) {
+        return write_all(data, size) ? count : 0;
+    }
+    traits_type::copy(pptr(), data, size);
+    pbump(static_cast<int>(size));
+    return count;
+}
+
+int BufferedWriter::sync() {
+    return flush_buffer() ? 0 : -1;
+}
+
+bool BufferedWriter::flush_buffer() {
+    size_t pending = static_cast<size_t>(pptr() - pbase());
+    bool success = pending == 0 || write_all(pbase(), pending);
+    setp(buffer.data(), buffer.data() + buffer.size());
+    return success;
+}
+
+bool BufferedWriter::write_all(const char* data, size_t count) {
+    while (count > 0) {
+        ssize_t written = ::write(fd, data, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        count -= static_cast<size_t>(written);
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <streambuf>
+#include <vector>
+
+// Stream buffer that writes straight to a file descriptor in large blocks.
+// Wrapping stdout in one of these keeps an export from paying for a write
+// call (or a flush from std::endl) per line.
+class BufferedWriter : public std::streambuf {
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit BufferedWriter(int fd, size_t capacity = DEFAULT_CAPACITY);
+    ~BufferedWriter() override;
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* data, std::streamsize count) override;
+    int sync() override;
+
+private:
+    int fd;
+    std::vector<char> buffer;
+
+    bool flush_buffer();
+    bool write_all(const char* data, size_t count);
+};
+
+#endif // BUFFERED_WRITER_H
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "result_writer.h"
+#include <charconv>
+#include <cmath>
+
+static const size_t FLUSH_THRESHOLD = 64 * 1024;
+
+// Width the table mode pads every cell to.
+static const size_t TABLE_CELL_WIDTH = 15;
+
+bool parse_output_mode(const std::string& name, OutputMode& mode) {
+    if (name == "table") mode = OutputMode::TABLE;
+    else if (name == "csv") mode = OutputMode::CSV;
+    else if (name == "json") mode = OutputMode::JSON;
+    else if (name == "binary") mode = OutputMode::BINARY;
+    else return false;
+    return true;
+}
+
+static void append_int(std::string& buf, int64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buf.append(digits, result.ptr);
+}
+
+// Shortest text that reads back as the same double.
+static void append_real(std::string& buf, double value) {
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buf.append(digits, result.ptr);
+}
+
+// Same text as an ostream with default formatting (%g, precision 6).
+static void append_real_general(std::string& buf, double value) {
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+    buf.append(digits, result.ptr);
+}
+
+template <typename T>
+static void append_raw(std::string& buf, const T& value) {
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void append_padded(std::string& buf, const std::string& text) {
+    if (text.size() < TABLE_CELL_WIDTH) {
+        buf.append(TABLE_CELL_WIDTH - text.size(), ' ');
+    }
+    buf += text;
+}
+
+static void append_csv_text(std::string& buf, const std::string& text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        buf += text;
+        return;
+    }
+    
+    buf += '"';
+    for (char c : text) {
+        if (c == '"') buf += '"';
+        buf += c;
+    }
+    buf += '"';
+}
+
+static void append_json_text(std::string& buf, const std::string& text) {
+    static const char HEX[] = "0123456789abcdef";
+    
+    buf += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': buf += "\\\""; break;
+            case '\\': buf += "\\\\"; break;
+            case '\n': buf += "\\n"; break;
+            case '\r': buf += "\\r"; break;
+            case '\t': buf += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    buf += "\\u00";
+                    buf += HEX[(c >> 4) & 0xf];
+                    buf += HEX[c & 0xf];
+                } else {
+                    buf += c;
+                }
+        }
+    }
+    buf += '"';
+}
+
+static void flush_if_full(std::ostream& out, std::string& buf) {
+    if (buf.size() >= FLUSH_THRESHOLD) {
+        out.write(buf.data(), buf.size());
+        buf.clear();
+    }
+}
+
+static void write_table(std::ostream& out, std::string& buf, const std::vector<Column>& columns,
+                        const std::vector<Row>& rows) {
+    for (const Column& col : columns) {
+        append_padded(buf, col.name);
+    }
+    buf += '\n';
+    for (size_t i = 0; i < columns.size(); ++i) {
+        append_padded(buf, std::string(10, '-'));
+    }
+    buf += '\n';
+    
+    std::string cell;
+    for (const Row& row : rows) {
+        for (const Value& val : row.values) {
+            cell.clear();
+            if (std::holds_alternative<int64_t>(val)) {
+                append_int(cell, std::get<int64_t>(val));
+            } else if (std::holds_alternative<double>(val)) {
+                append_real_general(cell, std::get<double>(val));
+            } else {
+                cell = std::get<std::string>(val);
+            }
+            append_padded(buf, cell);
+        }
+        buf += '\n';
+        flush_if_full(out, buf);
+    }
+}
+
+static void write_csv(std::ostream& out, std::string& buf, const std::vector<Column>& columns,
+                      const std::vector<Row>& rows) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) buf += ',';
+        append_csv_text(buf, columns[i].name);
+    }
+    buf += '\n';
+    
+    for (const Row& row : rows) {
+        for (size_t i = 0; i < row.values.size(); ++i) {
+            if (i > 0) buf += ',';
+            const Value& val = row.values[i];
+            if (std::holds_alternative<int64_t>(val)) {
+                append_int(buf, std::get<int64_t>(val));
+            } else if (std::holds_alternative<double>(val)) {
+                append_real(buf, std::get<double>(val));
+            } else {
+                append_csv_text(buf, std::get<std::string>(val));
+            }
+        }
+        buf += '\n';
+        flush_if_full(out, buf);
+    }
+}
+
+static void write_json(std::ostream& out, std::string& buf, const std::vector<Column>& columns,
+                       const std::vector<Row>& rows) {
+    // Keys are the same for every row, so escape them once.
+    std::vector<std::string> keys;
+    for (const Column& col : columns) {
+        std::string key;
+        append_json_text(key, col.name);
+        keys.push_back(key + ":");
+    }
+    
+    buf += '[';
+    for (size_t r = 0; r < rows.size(); ++r) {
+        buf += r == 0 ? "\n{" : ",\n{";
+        const Row& row = rows[r];
+        for (size_t i = 0; i < row.values.size(); ++i) {
+            if (i > 0) buf += ',';
+            buf += keys[i];
+            
+            const Value& val = row.values[i];
+            if (std::holds_alternative<int64_t>(val)) {
+                append_int(buf, std::get<int64_t>(val));
+            } else if (std::holds_alternative<double>(val)) {
+                double real = std::get<double>(val);
+                if (std::isfinite(real)) {
+                    append_real(buf, real);
+                } else {
+                    buf += "null";
+                }
+            } else {
+                append_json_text(buf, std::get<std::string>(val));
+            }
+        }
+        buf += '}';
+        flush_if_full(out, buf);
+    }
+    buf += "\n]\n";
+}
+
+static void write_binary(std::ostream& out, std::string& buf, const std::vector<Column>& columns,
+                         const std::vector<Row>& rows) {
+    buf += "MSQR";
+    append_raw(buf, static_cast<uint32_t>(columns.size()));
+    for (const Column& col : columns) {
+        append_raw(buf, static_cast<uint8_t>(col.type));
+        append_raw(buf, static_cast<uint32_t>(col.name.size()));
+        buf += col.name;
+    }
+    append_raw(buf, static_cast<uint64_t>(rows.size()));
+    
+    for (const Row& row : rows) {
+        for (const Value& val : row.values) {
+            if (std::holds_alternative<int64_t>(val)) {
+                append_raw(buf, std::get<int64_t>(val));
+            } else if (std::holds_alternative<double>(val)) {
+                append_raw(buf, std::get<double>(val));
+            } else {
+                const std::string& text = std::get<std::string>(val);
+                append_raw(buf, static_cast<uint32_t>(text.size()));
+                buf += text;
+            }
+        }
+        flush_if_full(out, buf);
+    }
+}
+
+void write_rows(std::ostream& out, OutputMode mode, const std::vector<Column>& columns,
+                const std::vector<Row>& rows) {
+    std::string buf;
+    buf.reserve(FLUSH_THRESHOLD * 2);
+    
+    switch (mode) {
+        case OutputMode::TABLE:
+            write_table(out, buf, columns, rows);
+            break;
+        case OutputMode::CSV:
+            write_csv(out, buf, columns, rows);
+            break;
+        case OutputMode::JSON:
+            write_json(out, buf, columns, rows);
+            break;
+        case OutputMode::BINARY:
+            write_binary(out, buf, columns, rows);
+            break;
+    }
+    
+    out.write(buf.data(), buf.size());
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+#include "../types.h"
+#include <ostream>
+
+enum class OutputMode {
+    TABLE,
+    CSV,
+    JSON,
+    BINARY
+};
+
+// Parses "table", "csv", "json" or "binary"; returns false for anything else.
+bool parse_output_mode(const std::string& name, OutputMode& mode);
+
+// Writes a result set in the given format. Cells are rendered into a local
+// buffer with std::to_chars and handed to the stream in large chunks, so the
+// cost per cell is a few byte copies rather than an iostream format call.
+//
+// BINARY layout, in native byte order: "MSQR", uint32 column count, then per
+// column a uint8 DataType, uint32 name length and name; uint64 row count,
+// then per cell an int64, a double, or a uint32 length and the text bytes.
+void write_rows(std::ostream& out, OutputMode mode, const std::vector<Column>& columns,
+                const std::vector<Row>& rows);
+
+#endif // RESULT_WRITER_H
\ No newline at end of file
@@ -8,10 +8,20 @@ ParsedCommand Parser::parse_command(const std::string& sql) {
     
     std::string upper_sql = to_upper(trim(sql));
     
-    if (upper_sql.find("CREATE TABLE") == 0) {
+    if (upper_sql.find("EXPLAIN") == 0) {
+        static const std::regex explain_regex(R"(^\s*EXPLAIN\s+(QUERY\s+PLAN\s+|ANALYZE\s+)?)", std::regex_constants::icase);
+        std::smatch matches;
+        
+        if (std::regex_search(sql, matches, explain_regex)) {
+            cmd = parse_command(matches.suffix().str());
+            bool analyze = matches[1].matched && to_upper(matches[1].str()).find("ANALYZE") == 0;
+            cmd.explain = analyze ? ExplainMode::ANALYZE : ExplainMode::QUERY_PLAN;
+        }
+    }
+    else if (upper_sql.find("CREATE TABLE") == 0) {
         cmd.type = SQLCommandType::CREATE_TABLE;
         
-        std::regex create_regex(R"(CREATE TABLE\s+(\w+)\s*\(([^)]+)\))");
+        static const std::regex create_regex(R"(CREATE TABLE\s+(\w+)\s*\(([^)]+)\))");
         std::smatch matches;
         
         if (std::regex_search(sql, matches, create_regex)) {
@@ -27,10 +37,44 @@ ParsedCommand Parser::parse_command(const std::string& sql) {
             }
         }
     }
+    else if (upper_sql.find("CREATE INDEX") == 0) {
+        cmd.type = SQLCommandType::CREATE_INDEX;
+        
+        static const std::regex index_regex(R"(CREATE INDEX\s+(\w+)\s+ON\s+(\w+)\s*\(\s*(\w+)\s*\))", std::regex_constants::icase);
+        std::smatch matches;
+        
+        if (std::regex_search(sql, matches, index_regex)) {
+            cmd.index_name = matches[1].str();
+            cmd.table_name = matches[2].str();
+            cmd.column_names.push_back(matches[3].str());
+        } else {
+            cmd.type = SQLCommandType::INVALID;
+        }
+    }
+    else if (upper_sql.find("ANALYZE") == 0) {
+        cmd.type = SQLCommandType::ANALYZE;
+        
+        static const std::regex analyze_regex(R"(ANALYZE\s+(\w+))", std::regex_constants::icase);
+        std::smatch matches;
+        
+        if (std::regex_search(sql, matches, analyze_regex)) {
+            cmd.table_name = matches[1].str();
+        }
+    }
+    else if (upper_sql.find("VACUUM") == 0) {
+        cmd.type = SQLCommandType::VACUUM;
+        
+        static const std::regex vacuum_regex(R"(VACUUM\s+(\w+))", std::regex_constants::icase);
+        std::smatch matches;
+        
+        if (std::regex_search(sql, matches, vacuum_regex)) {
+            cmd.table_name = matches[1].str();
+        }
+    }
     else if (upper_sql.find("INSERT INTO") == 0) {
         cmd.type = SQLCommandType::INSERT;
         
-        std::regex insert_regex(R"(INSERT INTO\s+(\w+)\s*(?:\(([^)]+)\))?\s*VALUES\s*\(([^)]+)\))");
+        static const std::regex insert_regex(R"(INSERT INTO\s+(\w+)\s*(?:\(([^)]+)\))?\s*VALUES\s*\(([^)]+)\))");
         std::smatch matches;
         
         if (std::regex_search(sql, matches, insert_regex)) {
@@ -54,7 +98,7 @@ ParsedCommand Parser::parse_command(const std::string& sql) {
     else if (upper_sql.find("SELECT") == 0) {
         cmd.type = SQLCommandType::SELECT;
         
-        std::regex select_regex(R"(SELECT\s+([^FROM]+)\s+FROM\s+(\w+)(?:\s+WHERE\s+(\w+)\s*=\s*(.+))?)");
+        static const std::regex select_regex(R"(SELECT\s+([^FROM]+)\s+FROM\s+(\w+)(?:\s+WHERE\s+(.+))?)");
         std::smatch matches;
         
         if (std::regex_search(sql, matches, select_regex)) {
@@ -68,39 +112,43 @@ ParsedCommand Parser::parse_command(const std::string& sql) {
                 }
             }
             
-            if (matches[3].matched && matches[4].matched) {
-                cmd.has_where = true;
-                cmd.where_column = matches[3].str();
-                cmd.where_value = parse_value(trim(matches[4].str()));
+            if (matches[3].matched) {
+                parse_where(matches[3].str(), cmd);
             }
         }
     }
     else if (upper_sql.find("UPDATE") == 0) {
         cmd.type = SQLCommandType::UPDATE;
         
-        std::regex update_regex(R"(UPDATE\s+(\w+)\s+SET\s+(\w+)\s*=\s*(.+?)\s+WHERE\s+(\w+)\s*=\s*(.+))");
+        static const std::regex update_regex(R"(UPDATE\s+(\w+)\s+SET\s+(.+?)\s+WHERE\s+(.+))");
         std::smatch matches;
         
         if (std::regex_search(sql, matches, update_regex)) {
             cmd.table_name = matches[1].str();
-            cmd.column_names.push_back(matches[2].str());
-            cmd.values.push_back(parse_value(trim(matches[3].str())));
-            cmd.has_where = true;
-            cmd.where_column = matches[4].str();
-            cmd.where_value = parse_value(trim(matches[5].str()));
+            
+            static const std::regex assignment_regex(R"(^(\w+)\s*=\s*(.+)$)");
+            for (const std::string& assignment : split_outside_quotes(matches[2].str(), ',')) {
+                std::smatch parts;
+                if (!std::regex_match(assignment, parts, assignment_regex)) {
+                    cmd.type = SQLCommandType::INVALID;
+                    return cmd;
+                }
+                cmd.column_names.push_back(parts[1].str());
+                cmd.set_exprs.push_back(trim(parts[2].str()));
+            }
+            
+            parse_where(matches[3].str(), cmd);
         }
     }
     else if (upper_sql.find("DELETE FROM") == 0) {
         cmd.type = SQLCommandType::DELETE;
         
-        std::regex delete_regex(R"(DELETE FROM\s+(\w+)\s+WHERE\s+(\w+)\s*=\s*(.+))");
+        static const std::regex delete_regex(R"(DELETE FROM\s+(\w+)\s+WHERE\s+(.+))");
         std::smatch matches;
         
         if (std::regex_search(sql, matches, delete_regex)) {
             cmd.table_name = matches[1].str();
-            cmd.has_where = true;
-            cmd.where_column = matches[2].str();
-            cmd.where_value = parse_value(trim(matches[3].str()));
+            parse_where(matches[2].str(), cmd);
         }
     }
     
@@ -125,6 +173,54 @@ std::vector<std::string> Parser::split(const std::string& str, char delimiter) {
     return tokens;
 }
 
+// Like split(), but delimiters inside '...' literals or parentheses are kept.
+std::vector<std::string> Parser::split_outside_quotes(const std::string& str, char delimiter) {
+    std::vector<std::string> tokens;
+    std::string token;
+    bool in_quotes = false;
+    int nesting = 0;
+    
+    for (char c : str) {
+        if (c == '\'') in_quotes = !in_quotes;
+        if (!in_quotes && c == '(') nesting++;
+        if (!in_quotes && c == ')') nesting--;
+        
+        if (c == delimiter && !in_quotes && nesting == 0) {
+            tokens.push_back(trim(token));
+            token.clear();
+        } else {
+            token += c;
+        }
+    }
+    tokens.push_back(trim(token));
+    
+    return tokens;
+}
+
+std::string Parser::strip_terminator(const std::string& str) {
+    std::string result = trim(str);
+    while (!result.empty() && result.back() == ';') {
+        result.pop_back();
+        result = trim(result);
+    }
+    return result;
+}
+
+void Parser::parse_where(const std::string& expr, ParsedCommand& cmd) {
+    cmd.has_where = true;
+    cmd.where_expr = strip_terminator(expr);
+    
+    // A lone comparison against a literal is also kept in decomposed form so
+    // the planner can use statistics and indexes for it.
+    static const std::regex comparison_regex(R"(^(\w+)\s*(<=|>=|<|>|=)\s*('[^']*'|[-+]?[0-9]*\.?[0-9]+)$)");
+    std::smatch matches;
+    if (std::regex_match(cmd.where_expr, matches, comparison_regex)) {
+        cmd.where_column = matches[1].str();
+        cmd.where_op = matches[2].str();
+        cmd.where_value = parse_value(matches[3].str());
+    }
+}
+
 std::string Parser::trim(const std::string& str) {
     size_t first = str.find_first_not_of(" \t\r\n");
     if (first == std::string::npos) return "";
@@ -16,6 +16,9 @@ public:
 private:
     std::string to_upper(const std::string& str);
     std::vector<std::string> split(const std::string& str, char delimiter);
+    std::vector<std::string> split_outside_quotes(const std::string& str, char delimiter);
+    std::string strip_terminator(const std::string& str);
+    void parse_where(const std::string& expr, ParsedCommand& cmd);
     std::string trim(const std::string& str);
     Value parse_value(const std::string& str);
     DataType parse_data_type(const std::string& type_str);
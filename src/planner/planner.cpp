@@ -0,0 +1,210 @@
+#include "planner.h"
+#include <algorithm>
+
+// Relative costs: reading one row in a sequential scan is the unit. An
+// index probe is a tree descent, and each row it yields is a random access.
+static const double SCAN_ROW_COST = 1.0;
+static const double INDEX_PROBE_COST = 1.0;
+static const double INDEX_ROW_COST = 2.0;
+
+// Fraction of rows assumed to match an equality or range predicate without
+// stats.
+static const double DEFAULT_SELECTIVITY = 0.1;
+static const double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3;
+
+static bool to_number(const Value& value, double& number) {
+    if (std::holds_alternative<int64_t>(value)) {
+        number = static_cast<double>(std::get<int64_t>(value));
+        return true;
+    }
+    if (std::holds_alternative<double>(value)) {
+        number = std::get<double>(value);
+        return true;
+    }
+    return false;
+}
+
+// True when no value within [min, max] can satisfy `column op value`.
+static bool outside_range(const ColumnStats& col, const std::string& op, const Value& value) {
+    if (!col.has_range) return false;
+    if (op == "=") return value < col.min || col.max < value;
+    if (op == "<") return !(col.min < value);
+    if (op == "<=") return value < col.min;
+    if (op == ">") return !(value < col.max);
+    if (op == ">=") return col.max < value;
+    return false;
+}
+
+QueryPlan Planner::plan_access(const ParsedCommand& cmd, const Table& table) const {
+    QueryPlan plan;
+    double row_count = table.live_row_count();
+    plan.estimated_rows = row_count;
+    plan.cost = row_count * SCAN_ROW_COST;
+    
+    if (!cmd.has_where) {
+        return plan;
+    }
+    
+    auto column = std::find_if(table.columns.begin(), table.columns.end(),
+        [&cmd](const Column& col) { return col.name == cmd.where_column; });
+    if (column == table.columns.end()) {
+        return plan;
+    }
+    size_t column_index = column - table.columns.begin();
+    
+    bool equality = cmd.where_op == "=";
+    plan.estimated_rows = equality ? estimate_equal(table, column_index, cmd.where_value)
+                                   : estimate_range(table, column_index, cmd.where_op, cmd.where_value);
+    if (plan.estimated_rows == 0 && table.stats.analyzed) {
+        plan.path = AccessPath::NO_MATCH;
+        plan.cost = 0;
+        return plan;
+    }
+    
+    for (const Index& index : table.indexes) {
+        if (index.column_index != column_index) continue;
+        
+        double cost = INDEX_PROBE_COST + plan.estimated_rows * INDEX_ROW_COST;
+        if (cost < plan.cost) {
+            plan.path = equality ? AccessPath::INDEX_LOOKUP : AccessPath::RANGE_SCAN;
+            plan.index_name = index.name;
+            plan.cost = cost;
+        }
+    }
+    
+    return plan;
+}
+
+double Planner::estimate_equal(const Table& table, size_t column_index, const Value& value) const {
+    double row_count = table.live_row_count();
+    if (row_count == 0) {
+        return 0;
+    }
+    
+    const TableStats& stats = table.stats;
+    if (!stats.analyzed) {
+        return std::max(1.0, row_count * DEFAULT_SELECTIVITY);
+    }
+    
+    // min/max are kept current on every write, so a value outside them
+    // cannot match no matter how stale the rest of the stats are.
+    const ColumnStats& col = stats.columns[column_index];
+    if (outside_range(col, "=", value)) {
+        return 0;
+    }
+    
+    if (col.histogram.empty() || stats.row_count == 0) {
+        return std::max(1.0, row_count * DEFAULT_SELECTIVITY);
+    }
+    
+    auto bucket = std::find_if(col.histogram.begin(), col.histogram.end(),
+        [&value](const HistogramBucket& b) { return !(b.upper < value); });
+    if (bucket == col.histogram.end()) {
+        bucket = col.histogram.end() - 1;
+    }
+    
+    double per_value = static_cast<double>(bucket->count) / std::max<size_t>(1, bucket->distinct);
+    return std::max(1.0, per_value * row_count / stats.row_count);
+}
+
+// Counts the histogram rows up to value: whole buckets below it, plus the
+// part of its own bucket found by interpolating numeric bounds (half the
+// bucket otherwise). The bucket's rows equal to value are estimated as in
+// estimate_equal, and the operator picks which side to keep.
+double Planner::estimate_range(const Table& table, size_t column_index, const std::string& op,
+                               const Value& value) const {
+    double row_count = table.live_row_count();
+    if (row_count == 0) {
+        return 0;
+    }
+    
+    const TableStats& stats = table.stats;
+    if (!stats.analyzed) {
+        return std::max(1.0, row_count * DEFAULT_RANGE_SELECTIVITY);
+    }
+    
+    const ColumnStats& col = stats.columns[column_index];
+    if (outside_range(col, op, value)) {
+        return 0;
+    }
+    
+    if (col.histogram.empty()) {
+        return std::max(1.0, row_count * DEFAULT_RANGE_SELECTIVITY);
+    }
+    
+    double total = 0;
+    double at_most = 0;
+    double equal = 0;
+    for (size_t i = 0; i < col.histogram.size(); ++i) {
+        const HistogramBucket& bucket = col.histogram[i];
+        total += bucket.count;
+        if (bucket.upper < value) {
+            at_most += bucket.count;
+            continue;
+        }
+        if (i > 0 && !(col.histogram[i - 1].upper < value)) {
+            continue;
+        }
+        
+        // value falls in this bucket: (previous upper, upper], or
+        // [min, upper] for the first one, whose rows at min come first.
+        double per_value = static_cast<double>(bucket.count) / std::max<size_t>(1, bucket.distinct);
+        const Value& lower = i > 0 ? col.histogram[i - 1].upper : col.min;
+        double low = 0, high = 0, point = 0;
+        double fraction = 0.5;
+        if (to_number(lower, low) && to_number(bucket.upper, high) && to_number(value, point) && high > low) {
+            fraction = std::clamp((point - low) / (high - low), 0.0, 1.0);
+        }
+        double spread = i > 0 ? bucket.count : std::max(0.0, bucket.count - per_value);
+        equal = per_value;
+        at_most += std::max(per_value, (i > 0 ? 0 : per_value) + fraction * spread);
+    }
+    if (total == 0) {
+        return std::max(1.0, row_count * DEFAULT_RANGE_SELECTIVITY);
+    }
+    
+    double matching = 0;
+    if (op == "<") {
+        matching = at_most - equal;
+    } else if (op == "<=") {
+        matching = at_most;
+    } else if (op == ">") {
+        matching = total - at_most;
+    } else {
+        matching = total - at_most + equal;
+    }
+    return std::max(1.0, std::max(0.0, matching) * row_count / total);
+}
+
+std::string Planner::describe(const ParsedCommand& cmd, const QueryPlan& plan) const {
+    std::string estimate = " (~" + std::to_string(static_cast<size_t>(plan.estimated_rows + 0.5)) + " rows)";
+    bool is_delete = cmd.type == SQLCommandType::DELETE;
+    
+    std::string predicate = " (" + cmd.where_column + " " + cmd.where_op + " ?)";
+    
+    switch (plan.path) {
+        case AccessPath::NO_MATCH:
+            return (is_delete ? "DELETE FROM " : "SEARCH ") + cmd.table_name + predicate +
+                   " NO MATCH: outside column range";
+        case AccessPath::INDEX_LOOKUP:
+        case AccessPath::RANGE_SCAN:
+            return (is_delete ? "DELETE FROM " : "SEARCH ") + cmd.table_name + " USING INDEX " + plan.index_name +
+                   predicate + estimate;
+        case AccessPath::FULL_SCAN:
+            break;
+    }
+    
+    return (is_delete ? "DELETE FROM " : "SCAN ") + cmd.table_name + describe_filter(cmd) + estimate;
+}
+
+std::string Planner::describe_filter(const ParsedCommand& cmd) {
+    if (!cmd.has_where) {
+        return "";
+    }
+    return " WHERE " + (cmd.where_column.empty() ? cmd.where_expr : cmd.where_column + " " + cmd.where_op + " ?");
+}
+
+bool Planner::needs_analyze(const Table& table) {
+    const TableStats& stats = table.stats;
+    return stats.analyzed && stats.modifications > stats.row_count / 5 + 20;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include "../types.h"
+#include <string>
+
+enum class AccessPath {
+    FULL_SCAN,
+    INDEX_LOOKUP,
+    RANGE_SCAN,
+    NO_MATCH
+};
+
+struct QueryPlan {
+    AccessPath path = AccessPath::FULL_SCAN;
+    std::string index_name;
+    double estimated_rows = 0;
+    double cost = 0;
+};
+
+class Planner {
+public:
+    Planner() = default;
+    ~Planner() = default;
+
+    // Chooses how to find the rows a SELECT or DELETE touches.
+    QueryPlan plan_access(const ParsedCommand& cmd, const Table& table) const;
+    std::string describe(const ParsedCommand& cmd, const QueryPlan& plan) const;
+    static std::string describe_filter(const ParsedCommand& cmd);
+
+    // True once enough rows have changed since ANALYZE that the stats
+    // should be refreshed. Plans made in the meantime use the old ones.
+    static bool needs_analyze(const Table& table);
+
+private:
+    double estimate_equal(const Table& table, size_t column_index, const Value& value) const;
+    double estimate_range(const Table& table, size_t column_index, const std::string& op, const Value& value) const;
+};
+
+#endif // PLANNER_H
\ No newline at end of file
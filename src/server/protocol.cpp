@@ -0,0 +1,95 @@
+#include "protocol.h"
+#include <stdexcept>
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const size_t HEADER_SIZE = 4;
+
+static void write_length(char* dest, uint32_t length) {
+    dest[0] = static_cast<char>((length >> 24) & 0xff);
+    dest[1] = static_cast<char>((length >> 16) & 0xff);
+    dest[2] = static_cast<char>((length >> 8) & 0xff);
+    dest[3] = static_cast<char>(length & 0xff);
+}
+
+static uint32_t read_length(const char* src) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(src);
+    return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+std::string encode_frame(const std::string& payload) {
+    if (payload.size() > MAX_FRAME_SIZE) {
+        throw std::runtime_error("Frame too large");
+    }
+    
+    std::string frame(HEADER_SIZE, '\0');
+    write_length(&frame[0], static_cast<uint32_t>(payload.size()));
+    frame += payload;
+    return frame;
+}
+
+bool decode_frame(const std::string& buffer, size_t& offset, std::string& payload) {
+    if (buffer.size() - offset < HEADER_SIZE) {
+        return false;
+    }
+    
+    uint32_t length = read_length(buffer.data() + offset);
+    if (length > MAX_FRAME_SIZE) {
+        throw std::runtime_error("Frame too large");
+    }
+    if (buffer.size() - offset - HEADER_SIZE < length) {
+        return false;
+    }
+    
+    payload.assign(buffer, offset + HEADER_SIZE, length);
+    offset += HEADER_SIZE + length;
+    return true;
+}
+
+static bool send_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+static bool recv_all(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t received = recv(fd, data, size, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+bool send_frame(int fd, const std::string& payload) {
+    if (payload.size() > MAX_FRAME_SIZE) {
+        return false;
+    }
+    std::string frame = encode_frame(payload);
+    return send_all(fd, frame.data(), frame.size());
+}
+
+bool recv_frame(int fd, std::string& payload) {
+    char header[HEADER_SIZE];
+    if (!recv_all(fd, header, HEADER_SIZE)) {
+        return false;
+    }
+    
+    uint32_t length = read_length(header);
+    if (length > MAX_FRAME_SIZE) {
+        return false;
+    }
+    
+    payload.resize(length);
+    return length == 0 || recv_all(fd, &payload[0], length);
+}
\ No newline at end of file
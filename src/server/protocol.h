@@ -0,0 +1,30 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+
+// Every message is a frame: a 4-byte big-endian payload length followed by
+// the payload. A request payload is one SQL statement. A response payload is
+// one ResponseStatus byte followed by the statement's output.
+enum class ResponseStatus : uint8_t {
+    OK = 0,
+    ERROR = 1
+};
+
+static const uint32_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+// Throws if payload exceeds MAX_FRAME_SIZE, which decode_frame and
+// recv_frame would refuse.
+std::string encode_frame(const std::string& payload);
+
+// Takes the frame starting at offset out of buffer and advances offset past
+// it. Returns false if the frame is not complete yet; throws if its length
+// exceeds MAX_FRAME_SIZE.
+bool decode_frame(const std::string& buffer, size_t& offset, std::string& payload);
+
+// Blocking send/receive on a connected socket, for clients.
+bool send_frame(int fd, const std::string& payload);
+bool recv_frame(int fd, std::string& payload);
+
+#endif // PROTOCOL_H
\ No newline at end of file
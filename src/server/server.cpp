@@ -0,0 +1,350 @@
+#include "server.h"
+#include "protocol.h"
+#include <iostream>
+#include <sstream>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// epoll user data for the two non-client descriptors; client ids start above.
+static const uint64_t LISTEN_ID = 0;
+static const uint64_t WAKE_ID = 1;
+
+static const int MAX_EVENTS = 64;
+static const size_t READ_CHUNK = 64 * 1024;
+
+// Unconsumed input a client may have buffered: one maximal frame and its
+// length prefix.
+static const size_t MAX_BUFFERED_INPUT = MAX_FRAME_SIZE + 4;
+
+Server::Server(Executor& executor, const std::string& socket_path, size_t worker_count)
+    : executor(executor), socket_path(socket_path), worker_count(worker_count == 0 ? 1 : worker_count),
+      next_connection_id(WAKE_ID + 1) {
+}
+
+Server::~Server() {
+    shutdown();
+}
+
+void Server::stop() {
+    stopping = true;
+    if (wake_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+bool Server::open_socket() {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << socket_path << "\n";
+        return false;
+    }
+    std::strcpy(addr.sun_path, socket_path.c_str());
+    
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    
+    unlink(socket_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd, SOMAXCONN) < 0) {
+        std::cerr << "Cannot listen on " << socket_path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0) {
+        std::cerr << "epoll/eventfd: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_ID;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+    event.data.u64 = WAKE_ID;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+    return true;
+}
+
+bool Server::run() {
+    if (!open_socket()) {
+        shutdown();
+        return false;
+    }
+    
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back(&Server::worker_loop, this);
+    }
+    std::cout << "Listening on " << socket_path << " with " << worker_count << " workers\n";
+    
+    epoll_event events[MAX_EVENTS];
+    while (!stopping) {
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait: " << std::strerror(errno) << "\n";
+            break;
+        }
+        
+        for (int i = 0; i < ready; ++i) {
+            uint64_t id = events[i].data.u64;
+            
+            if (id == LISTEN_ID) {
+                accept_clients();
+                continue;
+            }
+            if (id == WAKE_ID) {
+                uint64_t count;
+                while (read(wake_fd, &count, sizeof(count)) > 0) {}
+                drain_completions();
+                continue;
+            }
+            
+            // The client may have been closed by an earlier event in this batch.
+            auto it = connections.find(id);
+            if (it == connections.end()) continue;
+            
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                close_client(id);
+                continue;
+            }
+            if ((events[i].events & EPOLLIN) && !read_client(id, it->second)) continue;
+            if ((events[i].events & EPOLLOUT) && write_client(id, it->second)) {
+                dispatch_next(id, it->second);
+            }
+        }
+    }
+    
+    shutdown();
+    return true;
+}
+
+void Server::accept_clients() {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "accept: " << std::strerror(errno) << "\n";
+            }
+            return;
+        }
+        
+        uint64_t id = next_connection_id++;
+        Connection& conn = connections[id];
+        conn.fd = fd;
+        conn.events = EPOLLIN | EPOLLRDHUP;
+        
+        epoll_event event;
+        event.events = conn.events;
+        event.data.u64 = id;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+bool Server::read_client(uint64_t id, Connection& conn) {
+    char chunk[READ_CHUNK];
+    while (conn.in.size() - conn.in_offset < MAX_BUFFERED_INPUT) {
+        ssize_t received = read(conn.fd, chunk, sizeof(chunk));
+        if (received > 0) {
+            conn.in.append(chunk, received);
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        
+        // EOF or error: any statement still running is answered into the void.
+        close_client(id);
+        return false;
+    }
+    
+    return dispatch_next(id, conn);
+}
+
+// Starts the next buffered statement once the previous response has been
+// fully sent, so a client that pipelines without reading its responses
+// stalls instead of piling them up in conn.out.
+bool Server::dispatch_next(uint64_t id, Connection& conn) {
+    if (!conn.busy && conn.out_offset == conn.out.size()) {
+        std::string sql;
+        bool complete = false;
+        try {
+            complete = decode_frame(conn.in, conn.in_offset, sql);
+        } catch (const std::exception&) {
+            close_client(id);
+            return false;
+        }
+        
+        if (complete) {
+            // Drop consumed bytes once they make up most of the buffer.
+            if (conn.in_offset > conn.in.size() / 2) {
+                conn.in.erase(0, conn.in_offset);
+                conn.in_offset = 0;
+            }
+            
+            conn.busy = true;
+            {
+                std::lock_guard<std::mutex> lock(jobs_mutex);
+                jobs.push_back({id, std::move(sql)});
+            }
+            jobs_ready.notify_one();
+        }
+    }
+    
+    update_events(id, conn);
+    return true;
+}
+
+bool Server::write_client(uint64_t id, Connection& conn) {
+    while (conn.out_offset < conn.out.size()) {
+        ssize_t sent = send(conn.fd, conn.out.data() + conn.out_offset, conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.out_offset += sent;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        
+        close_client(id);
+        return false;
+    }
+    
+    if (conn.out_offset == conn.out.size()) {
+        conn.out.clear();
+        conn.out_offset = 0;
+    }
+    return true;
+}
+
+// Reads only while the client has nothing in flight, nothing unsent and
+// room in its input buffer; writes only while a response is pending.
+void Server::update_events(uint64_t id, Connection& conn) {
+    bool pending = conn.out_offset < conn.out.size();
+    bool readable = !conn.busy && !pending && conn.in.size() - conn.in_offset < MAX_BUFFERED_INPUT;
+    
+    uint32_t events = 0;
+    if (readable) events |= EPOLLIN | EPOLLRDHUP;
+    if (pending) events |= EPOLLOUT;
+    if (events == conn.events) return;
+    
+    epoll_event event;
+    event.events = events;
+    event.data.u64 = id;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn.fd, &event);
+    conn.events = events;
+}
+
+void Server::drain_completions() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex);
+        ready.swap(completions);
+    }
+    
+    for (Completion& completion : ready) {
+        auto it = connections.find(completion.connection_id);
+        if (it == connections.end()) continue;
+        
+        Connection& conn = it->second;
+        conn.busy = false;
+        conn.out += completion.frame;
+        
+        // Pipelined requests already buffered start once this answer is sent.
+        if (write_client(completion.connection_id, conn)) {
+            dispatch_next(completion.connection_id, conn);
+        }
+    }
+}
+
+void Server::close_client(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    connections.erase(it);
+}
+
+void Server::worker_loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex);
+            jobs_ready.wait(lock, [this] { return workers_done || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        
+        std::ostringstream out;
+        ResponseStatus status = ResponseStatus::OK;
+        try {
+            if (!executor.execute_command(job.sql, out)) {
+                status = ResponseStatus::ERROR;
+            }
+        } catch (const std::exception& e) {
+            out << "Error: " << e.what() << "\n";
+            status = ResponseStatus::ERROR;
+        }
+        
+        std::string payload(1, static_cast<char>(status));
+        payload += out.str();
+        
+        // The statement has run, but its output cannot be sent in one frame.
+        if (payload.size() > MAX_FRAME_SIZE) {
+            std::string message = "Error: result too large (" + std::to_string(payload.size() - 1) +
+                                  " bytes, limit " + std::to_string(MAX_FRAME_SIZE - 1) + ")\n";
+            payload.assign(1, static_cast<char>(ResponseStatus::ERROR));
+            payload += message;
+        }
+        {
+            std::lock_guard<std::mutex> lock(completions_mutex);
+            completions.push_back({job.connection_id, encode_frame(payload)});
+        }
+        
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void Server::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        workers_done = true;
+    }
+    jobs_ready.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    
+    for (auto& [id, conn] : connections) {
+        close(conn.fd);
+    }
+    connections.clear();
+    
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+        listen_fd = -1;
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    if (wake_fd >= 0) {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "../executor/executor.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Serves the framed protocol from protocol.h on a Unix domain socket. One
+// thread runs an epoll loop that accepts clients and moves bytes; a pool of
+// workers executes statements against the shared Executor. Each client has
+// at most one statement in flight, so its responses come back in order.
+class Server {
+public:
+    Server(Executor& executor, const std::string& socket_path, size_t worker_count);
+    ~Server();
+
+    // Blocks until stop() is called. Returns false if the socket could not
+    // be set up.
+    bool run();
+
+    // Async-signal-safe.
+    void stop();
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string in;
+        size_t in_offset = 0;
+        std::string out;
+        size_t out_offset = 0;
+        bool busy = false;
+        uint32_t events = 0;      // current epoll interest mask
+    };
+
+    struct Job {
+        uint64_t connection_id;
+        std::string sql;
+    };
+
+    struct Completion {
+        uint64_t connection_id;
+        std::string frame;
+    };
+
+    Executor& executor;
+    std::string socket_path;
+    size_t worker_count;
+
+    int listen_fd = -1;
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::atomic<bool> stopping{false};
+
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t next_connection_id;
+
+    std::vector<std::thread> workers;
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_ready;
+    std::deque<Job> jobs;
+    bool workers_done = false;
+
+    std::mutex completions_mutex;
+    std::vector<Completion> completions;
+
+    bool open_socket();
+    void accept_clients();
+    bool read_client(uint64_t id, Connection& conn);
+    bool write_client(uint64_t id, Connection& conn);
+    void update_events(uint64_t id, Connection& conn);
+    bool dispatch_next(uint64_t id, Connection& conn);
+    void drain_completions();
+    void close_client(uint64_t id);
+    void worker_loop();
+    void shutdown();
+};
+
+#endif // SERVER_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "deletion_bitmap.h"
+
+void DeletionBitmap::resize(size_t rows) {
+    words.resize((rows + 63) / 64, 0);
+    block_counts.resize((rows + BLOCK_ROWS - 1) / BLOCK_ROWS, 0);
+}
+
+void DeletionBitmap::clear() {
+    words.clear();
+    block_counts.clear();
+    total = 0;
+}
+
+bool DeletionBitmap::mark(size_t row) {
+    if (row / 64 >= words.size()) {
+        resize(row + 1);
+    }
+    
+    uint64_t bit = uint64_t(1) << (row % 64);
+    if (words[row / 64] & bit) {
+        return false;
+    }
+    
+    words[row / 64] |= bit;
+    block_counts[row / BLOCK_ROWS]++;
+    total++;
+    return true;
+}
+
+size_t DeletionBitmap::deleted_in_block(size_t block) const {
+    return block < block_counts.size() ? block_counts[block] : 0;
+}
+
+void DeletionBitmap::live_rows(size_t begin, size_t end, std::vector<size_t>& out) const {
+    for (size_t row = begin; row < end; ++row) {
+        size_t word = row / 64;
+        
+        // Step over a fully deleted word in one go.
+        if (row % 64 == 0 && word < words.size() && words[word] == ~uint64_t(0)) {
+            row += 63;
+            continue;
+        }
+        if (!is_deleted(row)) {
+            out.push_back(row);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef DELETION_BITMAP_H
+#define DELETION_BITMAP_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Tombstones for a table's rows. Rows are grouped into fixed-size blocks and
+// each block keeps a count of its deleted rows, so a scan can take a block
+// whole when it is clean, skip it when it is empty, and only test bits in
+// between.
+class DeletionBitmap {
+public:
+    static const size_t BLOCK_ROWS = 1024;
+
+    DeletionBitmap() = default;
+    ~DeletionBitmap() = default;
+
+    void clear();
+
+    bool is_deleted(size_t row) const {
+        return row / 64 < words.size() && (words[row / 64] >> (row % 64)) & 1;
+    }
+    bool mark(size_t row);
+
+    size_t deleted_count() const { return total; }
+    size_t deleted_in_block(size_t block) const;
+
+    // Appends the live row positions in [begin, end).
+    void live_rows(size_t begin, size_t end, std::vector<size_t>& out) const;
+
+private:
+    std::vector<uint64_t> words;
+    std::vector<uint32_t> block_counts;
+    size_t total = 0;
+
+    void resize(size_t rows);
+};
+
+#endif // DELETION_BITMAP_H
\ No newline at end of file
@@ -1,7 +1,101 @@
 #include "storage.h"
 #include <iostream>
 #include <sstream>
-#include <iomanip>
+#include <algorithm>
+#include "../vm/vm.h"
+
+// Approximate number of bytes a scan touches when it reads a row.
+static size_t row_size(const Row& row) {
+    size_t size = 0;
+    for (const Value& val : row.values) {
+        if (std::holds_alternative<std::string>(val)) {
+            size += std::get<std::string>(val).size();
+        } else {
+            size += sizeof(int64_t);
+        }
+    }
+    return size;
+}
+
+// Collects the positions of live rows that satisfy where, a block at a time:
+// clean blocks go to the VM as a range, fully deleted ones are skipped.
+static void scan_table(const Table& table, const Program& where, VM& vm, std::vector<size_t>& selection,
+                       ScanStats* stats) {
+    std::vector<size_t> candidates;
+    
+    for (size_t begin = 0; begin < table.rows.size(); begin += DeletionBitmap::BLOCK_ROWS) {
+        size_t end = std::min(table.rows.size(), begin + DeletionBitmap::BLOCK_ROWS);
+        size_t deleted = table.deleted.deleted_in_block(begin / DeletionBitmap::BLOCK_ROWS);
+        
+        candidates.clear();
+        if (deleted == 0) {
+            if (stats) {
+                for (size_t pos = begin; pos < end; ++pos) candidates.push_back(pos);
+            }
+            vm.filter(where, table.rows, begin, end, selection);
+        } else if (deleted < end - begin) {
+            table.deleted.live_rows(begin, end, candidates);
+            vm.filter(where, table.rows, candidates, selection);
+        }
+        
+        if (stats) {
+            for (size_t pos : candidates) {
+                stats->bytes_read += row_size(table.rows[pos]);
+            }
+            stats->rows_scanned += candidates.size();
+        }
+    }
+    
+    if (stats) {
+        stats->rows_matched += selection.size();
+    }
+}
+
+static const size_t HISTOGRAM_BUCKETS = 16;
+
+// Background compaction only rewrites a table once at least this many rows
+// and this fraction of it are tombstones.
+static const size_t COMPACT_MIN_DELETED = DeletionBitmap::BLOCK_ROWS;
+static const double COMPACT_MIN_FRACTION = 0.25;
+
+static void write_value(std::ofstream& file, const Value& val) {
+    uint8_t tag = static_cast<uint8_t>(val.index());
+    file.write(reinterpret_cast<const char*>(&tag), sizeof(tag));
+    
+    if (std::holds_alternative<int64_t>(val)) {
+        int64_t int_val = std::get<int64_t>(val);
+        file.write(reinterpret_cast<const char*>(&int_val), sizeof(int_val));
+    } else if (std::holds_alternative<std::string>(val)) {
+        const std::string& str_val = std::get<std::string>(val);
+        size_t str_length = str_val.length();
+        file.write(reinterpret_cast<const char*>(&str_length), sizeof(str_length));
+        file.write(str_val.c_str(), str_length);
+    } else {
+        double real_val = std::get<double>(val);
+        file.write(reinterpret_cast<const char*>(&real_val), sizeof(real_val));
+    }
+}
+
+static Value read_value(std::ifstream& file) {
+    uint8_t tag = 0;
+    file.read(reinterpret_cast<char*>(&tag), sizeof(tag));
+    
+    if (tag == 0) {
+        int64_t int_val = 0;
+        file.read(reinterpret_cast<char*>(&int_val), sizeof(int_val));
+        return int_val;
+    } else if (tag == 1) {
+        size_t str_length = 0;
+        file.read(reinterpret_cast<char*>(&str_length), sizeof(str_length));
+        std::string str_val(str_length, '\0');
+        file.read(&str_val[0], str_length);
+        return str_val;
+    }
+    
+    double real_val = 0;
+    file.read(reinterpret_cast<char*>(&real_val), sizeof(real_val));
+    return real_val;
+}
 
 Storage::Storage(const std::string& filename) : db_file(filename) {
     load_from_file();
@@ -13,7 +107,7 @@ Storage::~Storage() {
 
 bool Storage::create_table(const std::string& name, const std::vector<Column>& columns) {
     if (tables.find(name) != tables.end()) {
-        std::cout << "Table '" << name << "' already exists\n";
+        *output << "Table '" << name << "' already exists\n";
         return false;
     }
     
@@ -22,143 +116,481 @@ bool Storage::create_table(const std::string& name, const std::vector<Column>& c
     table.columns = columns;
     tables[name] = table;
     
-    std::cout << "Table '" << name << "' created successfully\n";
+    *output << "Table '" << name << "' created successfully\n";
+    return true;
+}
+
+bool Storage::create_index(const std::string& index_name, const std::string& table_name, const std::string& column) {
+    auto it = tables.find(table_name);
+    if (it == tables.end()) {
+        *output << "Table '" << table_name << "' does not exist\n";
+        return false;
+    }
+    
+    for (const auto& [name, table] : tables) {
+        for (const Index& index : table.indexes) {
+            if (index.name == index_name) {
+                *output << "Index '" << index_name << "' already exists\n";
+                return false;
+            }
+        }
+    }
+    
+    Table& table = it->second;
+    
+    int column_index = -1;
+    for (size_t i = 0; i < table.columns.size(); ++i) {
+        if (table.columns[i].name == column) {
+            column_index = i;
+            break;
+        }
+    }
+    
+    if (column_index == -1) {
+        *output << "Column '" << column << "' does not exist\n";
+        return false;
+    }
+    
+    Index index;
+    index.name = index_name;
+    index.column_index = column_index;
+    rebuild_index(table, index);
+    table.indexes.push_back(index);
+    
+    *output << "Index '" << index_name << "' created successfully\n";
+    return true;
+}
+
+bool Storage::analyze(const std::string& table_name) {
+    auto it = tables.find(table_name);
+    if (it == tables.end()) {
+        *output << "Table '" << table_name << "' does not exist\n";
+        return false;
+    }
+    
+    analyze_table(it->second);
     return true;
 }
 
+void Storage::analyze_table(Table& table) {
+    TableStats stats;
+    stats.analyzed = true;
+    stats.row_count = table.live_row_count();
+    
+    size_t bucket_size = std::max<size_t>(1, (stats.row_count + HISTOGRAM_BUCKETS - 1) / HISTOGRAM_BUCKETS);
+    
+    for (size_t c = 0; c < table.columns.size(); ++c) {
+        std::vector<Value> values;
+        values.reserve(stats.row_count);
+        for (size_t i = 0; i < table.rows.size(); ++i) {
+            if (!table.deleted.is_deleted(i)) {
+                values.push_back(table.rows[i].values[c]);
+            }
+        }
+        std::sort(values.begin(), values.end());
+        
+        ColumnStats col;
+        if (!values.empty()) {
+            col.has_range = true;
+            col.min = values.front();
+            col.max = values.back();
+        }
+        
+        // A run of equal values never straddles two buckets, so a bucket's
+        // count / distinct is a fair estimate for any one of its values.
+        for (size_t i = 0; i < values.size(); ++i) {
+            bool new_value = i == 0 || values[i] != values[i - 1];
+            if (new_value) {
+                col.distinct_count++;
+            }
+            if (col.histogram.empty() || (new_value && col.histogram.back().count >= bucket_size)) {
+                HistogramBucket bucket;
+                bucket.upper = values[i];
+                col.histogram.push_back(bucket);
+            }
+            
+            HistogramBucket& bucket = col.histogram.back();
+            bucket.upper = values[i];
+            bucket.count++;
+            if (new_value) {
+                bucket.distinct++;
+            }
+        }
+        
+        stats.columns.push_back(col);
+    }
+    
+    table.stats = stats;
+}
+
+void Storage::rebuild_index(const Table& table, Index& index) {
+    index.entries.clear();
+    for (size_t i = 0; i < table.rows.size(); ++i) {
+        if (!table.deleted.is_deleted(i)) {
+            index.entries[table.rows[i].values[index.column_index]].push_back(i);
+        }
+    }
+    index.stale = false;
+}
+
+// Collects the live positions of the rows probe selects, in table order.
+bool Storage::probe_index(Table& table, const IndexProbe& probe, std::vector<size_t>& positions) {
+    auto index = std::find_if(table.indexes.begin(), table.indexes.end(),
+        [&probe](const Index& candidate) { return candidate.name == probe.index_name; });
+    if (index == table.indexes.end()) {
+        *output << "Index '" << probe.index_name << "' does not exist\n";
+        return false;
+    }
+    if (index->stale) {
+        rebuild_index(table, *index);
+    }
+    
+    auto first = index->entries.begin();
+    auto last = index->entries.end();
+    if (probe.op == "=") {
+        first = index->entries.lower_bound(probe.key);
+        last = index->entries.upper_bound(probe.key);
+    } else if (probe.op == "<") {
+        last = index->entries.lower_bound(probe.key);
+    } else if (probe.op == "<=") {
+        last = index->entries.upper_bound(probe.key);
+    } else if (probe.op == ">") {
+        first = index->entries.upper_bound(probe.key);
+    } else if (probe.op == ">=") {
+        first = index->entries.lower_bound(probe.key);
+    }
+    
+    for (auto entry = first; entry != last; ++entry) {
+        for (size_t pos : entry->second) {
+            if (!table.deleted.is_deleted(pos)) positions.push_back(pos);
+        }
+    }
+    
+    // A range visits several keys; sorting returns its rows in the same
+    // order a scan would.
+    if (probe.op != "=") {
+        std::sort(positions.begin(), positions.end());
+    }
+    return true;
+}
+
+void Storage::widen_range(Table& table, size_t column_index, const Value& value) {
+    if (!table.stats.analyzed) return;
+    
+    ColumnStats& col = table.stats.columns[column_index];
+    if (!col.has_range) {
+        col.has_range = true;
+        col.min = value;
+        col.max = value;
+    } else if (value < col.min) {
+        col.min = value;
+    } else if (col.max < value) {
+        col.max = value;
+    }
+}
+
 bool Storage::insert_row(const std::string& table_name, const Row& row) {
     auto it = tables.find(table_name);
     if (it == tables.end()) {
-        std::cout << "Table '" << table_name << "' does not exist\n";
+        *output << "Table '" << table_name << "' does not exist\n";
         return false;
     }
     
     if (row.values.size() != it->second.columns.size()) {
-        std::cout << "Column count mismatch\n";
+        *output << "Column count mismatch\n";
         return false;
     }
     
-    it->second.rows.push_back(row);
-    std::cout << "Row inserted successfully\n";
+    Table& table = it->second;
+    
+    // Compiled expressions read columns by their declared type, so every
+    // stored value must already have that type.
+    Row typed = row;
+    for (size_t i = 0; i < typed.values.size(); ++i) {
+        if (!coerce_value(typed.values[i], table.columns[i].type)) {
+            *output << "Type mismatch for column '" << table.columns[i].name << "'\n";
+            return false;
+        }
+    }
+    table.rows.push_back(typed);
+    table.version++;
+    
+    for (Index& index : table.indexes) {
+        if (!index.stale) {
+            index.entries[typed.values[index.column_index]].push_back(table.rows.size() - 1);
+        }
+    }
+    
+    if (table.stats.analyzed) {
+        table.stats.row_count++;
+        table.stats.modifications++;
+        for (size_t i = 0; i < typed.values.size(); ++i) {
+            widen_range(table, i, typed.values[i]);
+        }
+    }
+    
+    *output << "Row inserted successfully\n";
     return true;
 }
 
-std::vector<Row> Storage::select_all(const std::string& table_name) {
+std::vector<Row> Storage::select_all(const std::string& table_name, ScanStats* stats) {
     auto it = tables.find(table_name);
     if (it == tables.end()) {
-        std::cout << "Table '" << table_name << "' does not exist\n";
+        *output << "Table '" << table_name << "' does not exist\n";
         return {};
     }
     
-    return it->second.rows;
+    const Table& table = it->second;
+    std::vector<Row> result;
+    result.reserve(table.live_row_count());
+    
+    for (size_t i = 0; i < table.rows.size(); ++i) {
+        if (table.deleted.is_deleted(i)) continue;
+        result.push_back(table.rows[i]);
+        if (stats) stats->bytes_read += row_size(table.rows[i]);
+    }
+    
+    if (stats) {
+        stats->rows_scanned += result.size();
+        stats->rows_matched += result.size();
+    }
+    
+    return result;
 }
 
-std::vector<Row> Storage::select_where(const std::string& table_name, const std::string& column, const Value& value) {
+std::vector<Row> Storage::select_where(const std::string& table_name, const Program& where, ScanStats* stats) {
     auto it = tables.find(table_name);
     if (it == tables.end()) {
-        std::cout << "Table '" << table_name << "' does not exist\n";
+        *output << "Table '" << table_name << "' does not exist\n";
         return {};
     }
     
     std::vector<Row> result;
     const Table& table = it->second;
     
-    int column_index = -1;
-    for (size_t i = 0; i < table.columns.size(); ++i) {
-        if (table.columns[i].name == column) {
-            column_index = i;
-            break;
-        }
+    VM vm;
+    std::vector<size_t> selection;
+    scan_table(table, where, vm, selection, stats);
+    
+    result.reserve(selection.size());
+    for (size_t pos : selection) {
+        result.push_back(table.rows[pos]);
     }
     
-    if (column_index == -1) {
-        std::cout << "Column '" << column << "' does not exist\n";
+    return result;
+}
+
+std::vector<Row> Storage::index_lookup(const std::string& table_name, const IndexProbe& probe, ScanStats* stats) {
+    auto it = tables.find(table_name);
+    if (it == tables.end()) {
+        *output << "Table '" << table_name << "' does not exist\n";
         return {};
     }
     
-    for (const Row& row : table.rows) {
-        if (row.values[column_index] == value) {
-            result.push_back(row);
-        }
+    Table& table = it->second;
+    
+    std::vector<Row> result;
+    std::vector<size_t> positions;
+    if (!probe_index(table, probe, positions)) {
+        return result;
+    }
+    
+    result.reserve(positions.size());
+    for (size_t pos : positions) {
+        result.push_back(table.rows[pos]);
+        if (stats) stats->bytes_read += row_size(table.rows[pos]);
+    }
+    
+    if (stats) {
+        stats->rows_scanned += result.size();
+        stats->rows_matched += result.size();
     }
     
     return result;
 }
 
-bool Storage::update_rows(const std::string& table_name, const std::string& set_column, const Value& set_value,
-                         const std::string& where_column, const Value& where_value) {
+bool Storage::update_rows(const std::string& table_name, const std::vector<Assignment>& assignments,
+                          const Program& where, ScanStats* stats) {
     auto it = tables.find(table_name);
     if (it == tables.end()) {
-        std::cout << "Table '" << table_name << "' does not exist\n";
+        *output << "Table '" << table_name << "' does not exist\n";
         return false;
     }
     
     Table& table = it->second;
     
-    int set_col_idx = -1, where_col_idx = -1;
-    for (size_t i = 0; i < table.columns.size(); ++i) {
-        if (table.columns[i].name == set_column) set_col_idx = i;
-        if (table.columns[i].name == where_column) where_col_idx = i;
+    // Evaluate every new value before writing any, so SET expressions see the
+    // original row and an error part-way through leaves the table untouched.
+    VM vm;
+    std::vector<size_t> selection;
+    scan_table(table, where, vm, selection, stats);
+    
+    std::vector<Value> new_values;
+    new_values.reserve(selection.size() * assignments.size());
+    for (size_t pos : selection) {
+        for (const Assignment& assignment : assignments) {
+            new_values.push_back(vm.evaluate(assignment.value, table.rows[pos]));
+        }
     }
     
-    if (set_col_idx == -1 || where_col_idx == -1) {
-        std::cout << "Column not found\n";
-        return false;
+    size_t next = 0;
+    for (size_t pos : selection) {
+        for (const Assignment& assignment : assignments) {
+            const Value& value = new_values[next++];
+            widen_range(table, assignment.column_index, value);
+            table.rows[pos].values[assignment.column_index] = value;
+        }
     }
     
-    int updated_count = 0;
-    for (Row& row : table.rows) {
-        if (row.values[where_col_idx] == where_value) {
-            row.values[set_col_idx] = set_value;
-            updated_count++;
+    int updated_count = selection.size();
+    if (updated_count > 0) {
+        table.version++;
+        for (Index& index : table.indexes) {
+            for (const Assignment& assignment : assignments) {
+                if (index.column_index == assignment.column_index) {
+                    index.stale = true;
+                }
+            }
+        }
+        if (table.stats.analyzed) {
+            table.stats.modifications += updated_count;
         }
     }
     
-    std::cout << "Updated " << updated_count << " rows\n";
+    *output << "Updated " << updated_count << " rows\n";
     return true;
 }
 
-bool Storage::delete_rows(const std::string& table_name, const std::string& where_column, const Value& where_value) {
+bool Storage::delete_rows(const std::string& table_name, const Program& where, const IndexProbe* probe,
+                          ScanStats* stats) {
     auto it = tables.find(table_name);
     if (it == tables.end()) {
-        std::cout << "Table '" << table_name << "' does not exist\n";
+        *output << "Table '" << table_name << "' does not exist\n";
         return false;
     }
     
     Table& table = it->second;
+    VM vm;
+    std::vector<size_t> selection;
     
-    int where_col_idx = -1;
-    for (size_t i = 0; i < table.columns.size(); ++i) {
-        if (table.columns[i].name == where_column) {
-            where_col_idx = i;
-            break;
+    if (probe) {
+        std::vector<size_t> candidates;
+        if (!probe_index(table, *probe, candidates)) {
+            return false;
+        }
+        if (stats) {
+            for (size_t pos : candidates) stats->bytes_read += row_size(table.rows[pos]);
+        }
+        if (!candidates.empty()) {
+            vm.filter(where, table.rows, candidates, selection);
         }
+        if (stats) {
+            stats->rows_scanned += candidates.size();
+            stats->rows_matched += selection.size();
+        }
+    } else {
+        scan_table(table, where, vm, selection, stats);
     }
     
-    if (where_col_idx == -1) {
-        std::cout << "Column '" << where_column << "' not found\n";
-        return false;
+    // Rows stay where they are, so indexes remain valid; scans and lookups
+    // skip tombstones until the table is compacted.
+    for (size_t pos : selection) {
+        table.deleted.mark(pos);
     }
     
-    auto original_size = table.rows.size();
-    table.rows.erase(
-        std::remove_if(table.rows.begin(), table.rows.end(),
-            [where_col_idx, &where_value](const Row& row) {
-                return row.values[where_col_idx] == where_value;
-            }),
-        table.rows.end()
-    );
+    int deleted_count = selection.size();
+    if (deleted_count > 0) {
+        table.version++;
+        if (table.stats.analyzed) {
+            table.stats.row_count -= std::min<size_t>(table.stats.row_count, deleted_count);
+            table.stats.modifications += deleted_count;
+        }
+    }
     
-    int deleted_count = original_size - table.rows.size();
-    std::cout << "Deleted " << deleted_count << " rows\n";
+    *output << "Deleted " << deleted_count << " rows\n";
     return true;
 }
 
+bool Storage::vacuum(const std::string& table_name) {
+    auto it = tables.find(table_name);
+    if (it == tables.end()) {
+        *output << "Table '" << table_name << "' does not exist\n";
+        return false;
+    }
+    
+    compact_table(it->second);
+    return true;
+}
+
+size_t Storage::compact_sparse_tables() {
+    size_t compacted = 0;
+    for (auto& [name, table] : tables) {
+        size_t deleted = table.deleted.deleted_count();
+        if (deleted >= COMPACT_MIN_DELETED && deleted >= table.rows.size() * COMPACT_MIN_FRACTION) {
+            compact_table(table);
+            compacted++;
+        }
+    }
+    return compacted;
+}
+
+void Storage::compact_table(Table& table) {
+    if (table.deleted.deleted_count() == 0) return;
+    
+    // Rows before the first tombstone keep their place; everything after
+    // slides down over the gaps.
+    size_t write = 0;
+    for (size_t read = 0; read < table.rows.size(); ++read) {
+        if (table.deleted.is_deleted(read)) continue;
+        if (write != read) {
+            table.rows[write] = std::move(table.rows[read]);
+        }
+        write++;
+    }
+    
+    table.rows.resize(write);
+    table.rows.shrink_to_fit();
+    table.deleted.clear();
+    
+    for (Index& index : table.indexes) {
+        index.stale = true;
+    }
+}
+
+bool Storage::coerce_value(Value& value, DataType type) {
+    switch (type) {
+        case DataType::INTEGER:
+            return std::holds_alternative<int64_t>(value);
+        case DataType::REAL:
+            if (std::holds_alternative<int64_t>(value)) {
+                value = static_cast<double>(std::get<int64_t>(value));
+            }
+            return std::holds_alternative<double>(value);
+        case DataType::TEXT:
+            return std::holds_alternative<std::string>(value);
+    }
+    return false;
+}
+
 Table* Storage::get_table(const std::string& name) {
     auto it = tables.find(name);
     return (it != tables.end()) ? &it->second : nullptr;
 }
 
+const Table* Storage::get_table(const std::string& name) const {
+    auto it = tables.find(name);
+    return (it != tables.end()) ? &it->second : nullptr;
+}
+
+std::vector<std::string> Storage::table_names() const {
+    std::vector<std::string> names;
+    for (const auto& [name, table] : tables) {
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
 void Storage::save_to_file() {
     std::ofstream file(db_file, std::ios::binary);
     if (!file.is_open()) return;
@@ -181,10 +613,13 @@ void Storage::save_to_file() {
             file.write(reinterpret_cast<const char*>(&col.type), sizeof(col.type));
         }
         
-        size_t row_count = table.rows.size();
+        size_t row_count = table.live_row_count();
         file.write(reinterpret_cast<const char*>(&row_count), sizeof(row_count));
         
-        for (const Row& row : table.rows) {
+        for (size_t r = 0; r < table.rows.size(); ++r) {
+            if (table.deleted.is_deleted(r)) continue;
+            
+            const Row& row = table.rows[r];
             for (size_t i = 0; i < row.values.size(); ++i) {
                 const Value& val = row.values[i];
                 DataType type = table.columns[i].type;
@@ -205,6 +640,60 @@ void Storage::save_to_file() {
         }
     }
     
+    // Statistics and index definitions follow the tables so that files
+    // written before they existed still load.
+    size_t stats_count = 0;
+    for (const auto& [name, table] : tables) {
+        if (table.stats.analyzed) stats_count++;
+    }
+    file.write(reinterpret_cast<const char*>(&stats_count), sizeof(stats_count));
+    
+    for (const auto& [name, table] : tables) {
+        if (!table.stats.analyzed) continue;
+        
+        size_t name_length = name.length();
+        file.write(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+        file.write(name.c_str(), name_length);
+        file.write(reinterpret_cast<const char*>(&table.stats.row_count), sizeof(table.stats.row_count));
+        file.write(reinterpret_cast<const char*>(&table.stats.modifications), sizeof(table.stats.modifications));
+        
+        for (const ColumnStats& col : table.stats.columns) {
+            file.write(reinterpret_cast<const char*>(&col.distinct_count), sizeof(col.distinct_count));
+            file.write(reinterpret_cast<const char*>(&col.has_range), sizeof(col.has_range));
+            if (col.has_range) {
+                write_value(file, col.min);
+                write_value(file, col.max);
+            }
+            
+            size_t bucket_count = col.histogram.size();
+            file.write(reinterpret_cast<const char*>(&bucket_count), sizeof(bucket_count));
+            for (const HistogramBucket& bucket : col.histogram) {
+                write_value(file, bucket.upper);
+                file.write(reinterpret_cast<const char*>(&bucket.count), sizeof(bucket.count));
+                file.write(reinterpret_cast<const char*>(&bucket.distinct), sizeof(bucket.distinct));
+            }
+        }
+    }
+    
+    size_t index_count = 0;
+    for (const auto& [name, table] : tables) {
+        index_count += table.indexes.size();
+    }
+    file.write(reinterpret_cast<const char*>(&index_count), sizeof(index_count));
+    
+    for (const auto& [name, table] : tables) {
+        for (const Index& index : table.indexes) {
+            size_t index_name_length = index.name.length();
+            file.write(reinterpret_cast<const char*>(&index_name_length), sizeof(index_name_length));
+            file.write(index.name.c_str(), index_name_length);
+            
+            size_t name_length = name.length();
+            file.write(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+            file.write(name.c_str(), name_length);
+            file.write(reinterpret_cast<const char*>(&index.column_index), sizeof(index.column_index));
+        }
+    }
+    
     file.close();
 }
 
@@ -272,41 +761,85 @@ void Storage::load_from_file() {
         tables[table_name] = table;
     }
     
+    size_t stats_count;
+    if (!file.read(reinterpret_cast<char*>(&stats_count), sizeof(stats_count))) return;
+    
+    for (size_t t = 0; t < stats_count; ++t) {
+        size_t name_length;
+        file.read(reinterpret_cast<char*>(&name_length), sizeof(name_length));
+        
+        std::string table_name(name_length, '\0');
+        file.read(&table_name[0], name_length);
+        
+        TableStats stats;
+        stats.analyzed = true;
+        file.read(reinterpret_cast<char*>(&stats.row_count), sizeof(stats.row_count));
+        file.read(reinterpret_cast<char*>(&stats.modifications), sizeof(stats.modifications));
+        
+        Table& table = tables[table_name];
+        for (size_t c = 0; c < table.columns.size(); ++c) {
+            ColumnStats col;
+            file.read(reinterpret_cast<char*>(&col.distinct_count), sizeof(col.distinct_count));
+            file.read(reinterpret_cast<char*>(&col.has_range), sizeof(col.has_range));
+            if (col.has_range) {
+                col.min = read_value(file);
+                col.max = read_value(file);
+            }
+            
+            size_t bucket_count;
+            file.read(reinterpret_cast<char*>(&bucket_count), sizeof(bucket_count));
+            for (size_t b = 0; b < bucket_count; ++b) {
+                HistogramBucket bucket;
+                bucket.upper = read_value(file);
+                file.read(reinterpret_cast<char*>(&bucket.count), sizeof(bucket.count));
+                file.read(reinterpret_cast<char*>(&bucket.distinct), sizeof(bucket.distinct));
+                col.histogram.push_back(bucket);
+            }
+            stats.columns.push_back(col);
+        }
+        table.stats = stats;
+    }
+    
+    size_t index_count;
+    if (!file.read(reinterpret_cast<char*>(&index_count), sizeof(index_count))) return;
+    
+    for (size_t i = 0; i < index_count; ++i) {
+        Index index;
+        size_t index_name_length;
+        file.read(reinterpret_cast<char*>(&index_name_length), sizeof(index_name_length));
+        index.name.resize(index_name_length);
+        file.read(&index.name[0], index_name_length);
+        
+        size_t name_length;
+        file.read(reinterpret_cast<char*>(&name_length), sizeof(name_length));
+        std::string table_name(name_length, '\0');
+        file.read(&table_name[0], name_length);
+        file.read(reinterpret_cast<char*>(&index.column_index), sizeof(index.column_index));
+        
+        // Entries are rebuilt on first use.
+        tables[table_name].indexes.push_back(index);
+    }
+    
     file.close();
 }
 
 void Storage::print_table(const std::string& table_name) {
     auto it = tables.find(table_name);
     if (it == tables.end()) {
-        std::cout << "Table '" << table_name << "' does not exist\n";
+        *output << "Table '" << table_name << "' does not exist\n";
         return;
     }
     
-    const Table& table = it->second;
-    
-    for (const Column& col : table.columns) {
-        std::cout << std::setw(15) << col.name;
-    }
-    std::cout << "\n";
-    
-    for (size_t i = 0; i < table.columns.size(); ++i) {
-        std::cout << std::setw(15) << std::string(10, '-');
+    print_rows(table_name, select_all(table_name));
+}
+
+void Storage::print_rows(const std::string& table_name, const std::vector<Row>& rows, std::ostream& out,
+                         OutputMode mode) {
+    auto it = tables.find(table_name);
+    if (it == tables.end()) {
+        *output << "Table '" << table_name << "' does not exist\n";
+        return;
     }
-    std::cout << "\n";
     
-    for (const Row& row : table.rows) {
-        for (size_t i = 0; i < row.values.size(); ++i) {
-            const Value& val = row.values[i];
-            std::cout << std::setw(15);
-            
-            if (std::holds_alternative<int64_t>(val)) {
-                std::cout << std::get<int64_t>(val);
-            } else if (std::holds_alternative<std::string>(val)) {
-                std::cout << std::get<std::string>(val);
-            } else if (std::holds_alternative<double>(val)) {
-                std::cout << std::get<double>(val);
-            }
-        }
-        std::cout << "\n";
-    }
+    write_rows(out, mode, it->second.columns, rows);
 }
\ No newline at end of file
@@ -2,30 +2,67 @@
 #define STORAGE_H
 
 #include "../types.h"
+#include "../vm/program.h"
+#include "../output/result_writer.h"
 #include <unordered_map>
 #include <fstream>
+#include <iostream>
+
+// Restricts a lookup or DELETE to the index entries whose value compares to
+// key as op says: =, <, <=, > or >=.
+struct IndexProbe {
+    std::string index_name;
+    std::string op = "=";
+    Value key;
+};
 
 class Storage {
 private:
     std::unordered_map<std::string, Table> tables;
     std::string db_file;
+    std::ostream* output = &std::cout;
 
 public:
     Storage(const std::string& filename = "database.db");
     ~Storage();
 
+    // Where status and error messages go; the executor points this at the
+    // current statement's output.
+    void set_output(std::ostream& stream) { output = &stream; }
+
     bool create_table(const std::string& name, const std::vector<Column>& columns);
+    bool create_index(const std::string& index_name, const std::string& table_name, const std::string& column);
+    bool analyze(const std::string& table_name);
     bool insert_row(const std::string& table_name, const Row& row);
-    std::vector<Row> select_all(const std::string& table_name);
-    std::vector<Row> select_where(const std::string& table_name, const std::string& column, const Value& value);
-    bool update_rows(const std::string& table_name, const std::string& set_column, const Value& set_value,
-                     const std::string& where_column, const Value& where_value);
-    bool delete_rows(const std::string& table_name, const std::string& where_column, const Value& where_value);
+    std::vector<Row> select_all(const std::string& table_name, ScanStats* stats = nullptr);
+    std::vector<Row> select_where(const std::string& table_name, const Program& where, ScanStats* stats = nullptr);
+    std::vector<Row> index_lookup(const std::string& table_name, const IndexProbe& probe, ScanStats* stats = nullptr);
+    bool update_rows(const std::string& table_name, const std::vector<Assignment>& assignments,
+                     const Program& where, ScanStats* stats = nullptr);
+    bool delete_rows(const std::string& table_name, const Program& where, const IndexProbe* probe = nullptr,
+                     ScanStats* stats = nullptr);
+    bool vacuum(const std::string& table_name);
+    size_t compact_sparse_tables();
+    
+    // Converts value to the column type where that is lossless (INTEGER to
+    // REAL); returns false if the value cannot be stored in such a column.
+    static bool coerce_value(Value& value, DataType type);
     
     Table* get_table(const std::string& name);
+    const Table* get_table(const std::string& name) const;
+    std::vector<std::string> table_names() const;
     void save_to_file();
     void load_from_file();
     void print_table(const std::string& table_name);
+    void print_rows(const std::string& table_name, const std::vector<Row>& rows, std::ostream& out = std::cout,
+                    OutputMode mode = OutputMode::TABLE);
+
+private:
+    void analyze_table(Table& table);
+    void compact_table(Table& table);
+    void rebuild_index(const Table& table, Index& index);
+    bool probe_index(Table& table, const IndexProbe& probe, std::vector<size_t>& positions);
+    void widen_range(Table& table, size_t column_index, const Value& value);
 };
 
 #endif // STORAGE_H
\ No newline at end of file
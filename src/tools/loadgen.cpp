@@ -0,0 +1,150 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "server/protocol.h"
+
+// Load generator for `mini_sqlite --serve`: each client thread opens its own
+// connection and sends the same statement back to back, waiting for every
+// response before sending the next.
+
+struct ClientResult {
+    size_t ok = 0;
+    size_t errors = 0;      // answered with an ERROR status
+    size_t unsent = 0;      // never completed because the connection failed
+    std::vector<double> latencies_ms;
+    bool connected = false;
+};
+
+static int connect_socket(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void run_client(const std::string& path, const std::string& query, size_t requests, ClientResult& result) {
+    int fd = connect_socket(path);
+    if (fd < 0) {
+        result.unsent = requests;
+        return;
+    }
+    result.connected = true;
+    result.latencies_ms.reserve(requests);
+    
+    std::string response;
+    for (size_t i = 0; i < requests; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        if (!send_frame(fd, query) || !recv_frame(fd, response) || response.empty()) {
+            result.unsent = requests - i;
+            break;
+        }
+        result.latencies_ms.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        
+        if (response[0] == 0) {
+            result.ok++;
+        } else {
+            result.errors++;
+        }
+    }
+    
+    close(fd);
+}
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+static void print_usage() {
+    std::cout << "Usage: mini_sqlite_loadgen SOCKET [--clients N] [--requests N] [--query SQL]\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_usage();
+        return 1;
+    }
+    
+    std::string path = argv[1];
+    size_t clients = 4;
+    size_t requests = 1000;
+    std::string query = "SELECT * FROM users WHERE id = 1;";
+    
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            print_usage();
+            return 1;
+        }
+        if (arg == "--clients") {
+            clients = std::stoul(argv[++i]);
+        } else if (arg == "--requests") {
+            requests = std::stoul(argv[++i]);
+        } else if (arg == "--query") {
+            query = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    
+    std::vector<ClientResult> results(clients);
+    std::vector<std::thread> threads;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < clients; ++i) {
+        threads.emplace_back(run_client, path, query, requests, std::ref(results[i]));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    size_t ok = 0, errors = 0, unsent = 0, connected = 0;
+    std::vector<double> latencies;
+    for (const ClientResult& result : results) {
+        ok += result.ok;
+        errors += result.errors;
+        unsent += result.unsent;
+        connected += result.connected ? 1 : 0;
+        latencies.insert(latencies.end(), result.latencies_ms.begin(), result.latencies_ms.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    
+    if (connected == 0) {
+        std::cerr << "Could not connect to " << path << "\n";
+        return 1;
+    }
+    
+    std::cout << "Clients:      " << connected << "\n";
+    // Throughput counts completed round trips only, not requests a failed
+    // connection never sent.
+    std::cout << "Requests:     " << ok + errors << " (" << errors << " errors)\n";
+    if (unsent > 0) {
+        std::cout << "Unsent:       " << unsent << " (connection failed)\n";
+    }
+    std::cout << "Elapsed:      " << elapsed << " s\n";
+    std::cout << "Throughput:   " << latencies.size() / elapsed << " queries/s\n";
+    std::cout << "Latency (ms): p50 " << percentile(latencies, 0.50)
+              << ", p95 " << percentile(latencies, 0.95)
+              << ", p99 " << percentile(latencies, 0.99) << "\n";
+    return errors == 0 && unsent == 0 ? 0 : 1;
+}
\ No newline at end of file
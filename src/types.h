@@ -5,6 +5,8 @@
 #include <vector>
 #include <variant>
 #include <memory>
+#include <map>
+#include "storage/deletion_bitmap.h"
 
 enum class DataType {
     INTEGER,
@@ -25,14 +27,63 @@ struct Row {
     std::vector<Value> values;
 };
 
+// Equi-depth histogram bucket: values in (previous upper, upper].
+struct HistogramBucket {
+    Value upper;
+    size_t count = 0;
+    size_t distinct = 0;
+};
+
+struct ColumnStats {
+    size_t distinct_count = 0;
+    bool has_range = false;
+    Value min;
+    Value max;
+    std::vector<HistogramBucket> histogram;
+};
+
+// Collected by ANALYZE. min/max are widened on every write so they stay a
+// safe bound; counts and histograms are estimates until the next ANALYZE.
+struct TableStats {
+    bool analyzed = false;
+    size_t row_count = 0;
+    size_t modifications = 0;
+    std::vector<ColumnStats> columns;
+};
+
+// In-memory ordered index from a column value to row positions, so it
+// serves range predicates as well as equality. Rebuilt lazily when a write
+// leaves it stale.
+struct Index {
+    std::string name;
+    size_t column_index = 0;
+    bool stale = true;
+    std::map<Value, std::vector<size_t>> entries;
+};
+
 struct Table {
     std::string name;
     std::vector<Column> columns;
-    std::vector<Row> rows;
+    std::vector<Row> rows;          // includes deleted rows until the table is compacted
+    DeletionBitmap deleted;
+    TableStats stats;
+    std::vector<Index> indexes;
+    uint64_t version = 0;           // bumped by every write that changes the rows
+
+    size_t live_row_count() const { return rows.size() - deleted.deleted_count(); }
+};
+
+struct ScanStats {
+    size_t rows_scanned = 0;
+    size_t rows_matched = 0;
+    size_t bytes_read = 0;
 };
 
 enum class SQLCommandType {
     CREATE_TABLE,
+    CREATE_INDEX,
+    ANALYZE,
+    VACUUM,
     INSERT,
     SELECT,
     UPDATE,
@@ -40,12 +91,23 @@ enum class SQLCommandType {
     INVALID
 };
 
+enum class ExplainMode {
+    NONE,
+    QUERY_PLAN,
+    ANALYZE
+};
+
 struct ParsedCommand {
     SQLCommandType type;
+    ExplainMode explain = ExplainMode::NONE;
     std::string table_name;
+    std::string index_name;
     std::vector<std::string> column_names;
     std::vector<Value> values;
-    std::string where_column;
+    std::vector<std::string> set_exprs;
+    std::string where_expr;
+    std::string where_column;   // set only when WHERE is a plain column <op> literal
+    std::string where_op;       // =, <, <=, > or >=
     Value where_value;
     bool has_where = false;
 };
@@ -0,0 +1,386 @@
+#include "compiler.h"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+// Comparison opcodes are laid out EQ, NE, LT, LE, GT, GE for each type.
+static const std::vector<std::string> COMPARISON_SYMBOLS = {"=", "<>", "<", "<=", ">", ">="};
+
+static int comparison_offset(const std::string& symbol) {
+    if (symbol == "==") return 0;
+    if (symbol == "!=") return 1;
+    auto it = std::find(COMPARISON_SYMBOLS.begin(), COMPARISON_SYMBOLS.end(), symbol);
+    return it == COMPARISON_SYMBOLS.end() ? -1 : static_cast<int>(it - COMPARISON_SYMBOLS.begin());
+}
+
+static OpCode offset_op(OpCode base, int offset) {
+    return static_cast<OpCode>(static_cast<int>(base) + offset);
+}
+
+static std::string type_name(ExprType type) {
+    switch (type) {
+        case ExprType::INTEGER: return "INTEGER";
+        case ExprType::REAL: return "REAL";
+        case ExprType::TEXT: return "TEXT";
+        case ExprType::BOOLEAN: return "BOOLEAN";
+    }
+    return "UNKNOWN";
+}
+
+Compiler::Compiler(const Table& table) : table(table) {
+}
+
+Program Compiler::compile_predicate(const std::string& expr) {
+    Program result = compile(expr);
+    program = &result;
+    result.result_type = condition(result.result_type, "WHERE clause");
+    program = nullptr;
+    return result;
+}
+
+Program Compiler::compile_value(const std::string& expr, DataType target) {
+    Program result = compile(expr);
+    program = &result;
+    
+    ExprType type = result.result_type;
+    bool assignable = type == ExprType::TEXT ? target == DataType::TEXT :
+                      type == ExprType::REAL ? target == DataType::REAL :
+                      target != DataType::TEXT;
+    if (!assignable) {
+        throw std::runtime_error("Cannot assign " + type_name(type) + " value to column of a different type");
+    }
+    
+    if (target == DataType::REAL && type != ExprType::REAL) {
+        emit(OpCode::INT_TO_REAL, 0);
+        result.result_type = ExprType::REAL;
+    } else if (target == DataType::INTEGER) {
+        result.result_type = ExprType::INTEGER;
+    }
+    
+    program = nullptr;
+    return result;
+}
+
+Program Compiler::compile(const std::string& expr) {
+    tokenize(expr);
+    pos = 0;
+    depth = 0;
+    
+    Program result;
+    program = &result;
+    result.result_type = parse_or();
+    
+    if (tokens[pos].type != TokenType::END) {
+        throw std::runtime_error("Unexpected '" + tokens[pos].text + "' in expression");
+    }
+    
+    program = nullptr;
+    return result;
+}
+
+void Compiler::tokenize(const std::string& expr) {
+    tokens.clear();
+    size_t i = 0;
+    
+    while (i < expr.size()) {
+        char c = expr[i];
+        
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            i++;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && i + 1 < expr.size() &&
+                   std::isdigit(static_cast<unsigned char>(expr[i + 1])))) {
+            size_t start = i;
+            size_t dots = 0;
+            while (i < expr.size() && (std::isdigit(static_cast<unsigned char>(expr[i])) || expr[i] == '.')) {
+                if (expr[i] == '.') dots++;
+                i++;
+            }
+            std::string text = expr.substr(start, i - start);
+            if (dots > 1) {
+                throw std::runtime_error("Malformed number '" + text + "'");
+            }
+            tokens.push_back({dots > 0 ? TokenType::REAL : TokenType::INTEGER, text});
+        } else if (c == '\'') {
+            size_t end = expr.find('\'', i + 1);
+            if (end == std::string::npos) {
+                throw std::runtime_error("Unterminated string literal");
+            }
+            tokens.push_back({TokenType::STRING, expr.substr(i + 1, end - i - 1)});
+            i = end + 1;
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = i;
+            while (i < expr.size() && (std::isalnum(static_cast<unsigned char>(expr[i])) || expr[i] == '_')) {
+                i++;
+            }
+            tokens.push_back({TokenType::IDENTIFIER, expr.substr(start, i - start)});
+        } else {
+            std::string two = expr.substr(i, 2);
+            if (two == "<=" || two == ">=" || two == "<>" || two == "!=" || two == "==") {
+                tokens.push_back({TokenType::SYMBOL, two});
+                i += 2;
+            } else if (std::string("=<>+-*/%()").find(c) != std::string::npos) {
+                tokens.push_back({TokenType::SYMBOL, std::string(1, c)});
+                i++;
+            } else {
+                throw std::runtime_error(std::string("Unexpected character '") + c + "' in expression");
+            }
+        }
+    }
+    
+    tokens.push_back({TokenType::END, "end of expression"});
+}
+
+ExprType Compiler::parse_or() {
+    ExprType left = parse_and();
+    while (match_keyword("OR")) {
+        condition(left, "OR");
+        size_t jump = program->code.size();
+        emit(OpCode::JUMP_IF_TRUE_OR_POP, -1);
+        ExprType right = parse_and();
+        condition(right, "OR");
+        program->code[jump].arg = program->code.size();
+        left = ExprType::BOOLEAN;
+    }
+    return left;
+}
+
+ExprType Compiler::parse_and() {
+    ExprType left = parse_not();
+    while (match_keyword("AND")) {
+        condition(left, "AND");
+        size_t jump = program->code.size();
+        emit(OpCode::JUMP_IF_FALSE_OR_POP, -1);
+        ExprType right = parse_not();
+        condition(right, "AND");
+        program->code[jump].arg = program->code.size();
+        left = ExprType::BOOLEAN;
+    }
+    return left;
+}
+
+ExprType Compiler::parse_not() {
+    if (match_keyword("NOT")) {
+        ExprType operand = parse_not();
+        condition(operand, "NOT");
+        emit(OpCode::NOT, 0);
+        return ExprType::BOOLEAN;
+    }
+    return parse_comparison();
+}
+
+ExprType Compiler::parse_comparison() {
+    ExprType left = parse_additive();
+    
+    const Token& token = tokens[pos];
+    int offset = token.type == TokenType::SYMBOL ? comparison_offset(token.text) : -1;
+    if (offset < 0) {
+        return left;
+    }
+    
+    std::string symbol = token.text;
+    pos++;
+    ExprType right = parse_additive();
+    ExprType operand = promote(left, right, symbol);
+    
+    OpCode base = operand == ExprType::TEXT ? OpCode::EQ_TEXT :
+                  operand == ExprType::REAL ? OpCode::EQ_REAL : OpCode::EQ_INT;
+    emit(offset_op(base, offset), -1);
+    return ExprType::BOOLEAN;
+}
+
+ExprType Compiler::parse_additive() {
+    ExprType left = parse_multiplicative();
+    while (true) {
+        bool add = match_symbol("+");
+        if (!add && !match_symbol("-")) {
+            return left;
+        }
+        
+        ExprType right = parse_multiplicative();
+        left = promote(left, right, add ? "+" : "-");
+        if (left == ExprType::TEXT) {
+            throw std::runtime_error("Arithmetic on TEXT is not supported");
+        }
+        
+        if (left == ExprType::REAL) {
+            emit(add ? OpCode::ADD_REAL : OpCode::SUB_REAL, -1);
+        } else {
+            emit(add ? OpCode::ADD_INT : OpCode::SUB_INT, -1);
+        }
+    }
+}
+
+ExprType Compiler::parse_multiplicative() {
+    ExprType left = parse_unary();
+    while (true) {
+        std::string symbol;
+        if (match_symbol("*")) symbol = "*";
+        else if (match_symbol("/")) symbol = "/";
+        else if (match_symbol("%")) symbol = "%";
+        else return left;
+        
+        ExprType right = parse_unary();
+        left = promote(left, right, symbol);
+        if (left == ExprType::TEXT) {
+            throw std::runtime_error("Arithmetic on TEXT is not supported");
+        }
+        
+        if (left == ExprType::REAL) {
+            if (symbol == "%") {
+                throw std::runtime_error("Operator % requires INTEGER operands");
+            }
+            emit(symbol == "*" ? OpCode::MUL_REAL : OpCode::DIV_REAL, -1);
+        } else {
+            emit(symbol == "*" ? OpCode::MUL_INT : symbol == "/" ? OpCode::DIV_INT : OpCode::MOD_INT, -1);
+        }
+    }
+}
+
+ExprType Compiler::parse_unary() {
+    if (match_symbol("-")) {
+        size_t start = program->code.size();
+        ExprType operand = parse_unary();
+        Instruction& last = program->code.back();
+        
+        // Fold negative literals instead of negating them at run time.
+        bool literal = program->code.size() == start + 1;
+        if (literal && last.op == OpCode::PUSH_INT) {
+            last.int_value = -last.int_value;
+        } else if (literal && last.op == OpCode::PUSH_REAL) {
+            last.real_value = -last.real_value;
+        } else if (operand == ExprType::REAL) {
+            emit(OpCode::NEG_REAL, 0);
+        } else if (operand == ExprType::TEXT) {
+            throw std::runtime_error("Cannot negate a TEXT value");
+        } else {
+            emit(OpCode::NEG_INT, 0);
+            operand = ExprType::INTEGER;
+        }
+        return operand;
+    }
+    return parse_primary();
+}
+
+ExprType Compiler::parse_primary() {
+    Token token = tokens[pos];
+    
+    switch (token.type) {
+        case TokenType::INTEGER:
+            pos++;
+            emit(OpCode::PUSH_INT, 1);
+            try {
+                program->code.back().int_value = std::stoll(token.text);
+            } catch (const std::out_of_range&) {
+                throw std::runtime_error("Integer literal out of range: " + token.text);
+            }
+            return ExprType::INTEGER;
+        case TokenType::REAL:
+            pos++;
+            emit(OpCode::PUSH_REAL, 1);
+            try {
+                program->code.back().real_value = std::stod(token.text);
+            } catch (const std::out_of_range&) {
+                throw std::runtime_error("Real literal out of range: " + token.text);
+            }
+            return ExprType::REAL;
+        case TokenType::STRING:
+            pos++;
+            program->text_constants.push_back(token.text);
+            emit(OpCode::PUSH_TEXT, 1, program->text_constants.size() - 1);
+            return ExprType::TEXT;
+        case TokenType::IDENTIFIER: {
+            pos++;
+            auto column = std::find_if(table.columns.begin(), table.columns.end(),
+                [&token](const Column& col) { return col.name == token.text; });
+            if (column == table.columns.end()) {
+                throw std::runtime_error("Column '" + token.text + "' does not exist");
+            }
+            
+            uint32_t index = column - table.columns.begin();
+            switch (column->type) {
+                case DataType::INTEGER:
+                    emit(OpCode::LOAD_INT, 1, index);
+                    return ExprType::INTEGER;
+                case DataType::REAL:
+                    emit(OpCode::LOAD_REAL, 1, index);
+                    return ExprType::REAL;
+                case DataType::TEXT:
+                    emit(OpCode::LOAD_TEXT, 1, index);
+                    return ExprType::TEXT;
+            }
+            return ExprType::TEXT;
+        }
+        case TokenType::SYMBOL:
+            if (match_symbol("(")) {
+                ExprType inner = parse_or();
+                if (!match_symbol(")")) {
+                    throw std::runtime_error("Expected ')' in expression");
+                }
+                return inner;
+            }
+            break;
+        case TokenType::END:
+            break;
+    }
+    
+    throw std::runtime_error("Unexpected '" + token.text + "' in expression");
+}
+
+bool Compiler::match_keyword(const std::string& keyword) {
+    const Token& token = tokens[pos];
+    if (token.type != TokenType::IDENTIFIER || token.text.size() != keyword.size()) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < keyword.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(token.text[i])) != keyword[i]) {
+            return false;
+        }
+    }
+    pos++;
+    return true;
+}
+
+bool Compiler::match_symbol(const std::string& symbol) {
+    if (tokens[pos].type == TokenType::SYMBOL && tokens[pos].text == symbol) {
+        pos++;
+        return true;
+    }
+    return false;
+}
+
+void Compiler::emit(OpCode op, int stack_effect, uint32_t arg) {
+    Instruction instruction;
+    instruction.op = op;
+    instruction.arg = arg;
+    program->code.push_back(instruction);
+    
+    depth += stack_effect;
+    program->max_stack = std::max(program->max_stack, depth);
+}
+
+ExprType Compiler::condition(ExprType type, const std::string& context) {
+    if (type == ExprType::INTEGER) {
+        emit(OpCode::TRUTH, 0);
+    } else if (type != ExprType::BOOLEAN) {
+        throw std::runtime_error(context + " requires a boolean or INTEGER operand, got " + type_name(type));
+    }
+    return ExprType::BOOLEAN;
+}
+
+ExprType Compiler::promote(ExprType left, ExprType right, const std::string& op) {
+    if (left == ExprType::BOOLEAN) left = ExprType::INTEGER;
+    if (right == ExprType::BOOLEAN) right = ExprType::INTEGER;
+    
+    if (left == right) {
+        return left;
+    }
+    
+    if (left == ExprType::TEXT || right == ExprType::TEXT) {
+        throw std::runtime_error("Type mismatch: " + type_name(left) + " " + op + " " + type_name(right));
+    }
+    
+    // One side is INTEGER and the other REAL.
+    emit(left == ExprType::INTEGER ? OpCode::INT_TO_REAL_UNDER : OpCode::INT_TO_REAL, 0);
+    return ExprType::REAL;
+}
\ No newline at end of file
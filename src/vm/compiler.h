@@ -0,0 +1,58 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "program.h"
+#include <string>
+
+// Compiles WHERE and SET expressions against a table's schema. Column
+// references and operand types are resolved here, once, so the VM only
+// ever executes type-specialized opcodes. Errors throw std::runtime_error.
+class Compiler {
+public:
+    explicit Compiler(const Table& table);
+    ~Compiler() = default;
+
+    Program compile_predicate(const std::string& expr);
+    Program compile_value(const std::string& expr, DataType target);
+
+private:
+    enum class TokenType {
+        INTEGER,
+        REAL,
+        STRING,
+        IDENTIFIER,
+        SYMBOL,
+        END
+    };
+
+    struct Token {
+        TokenType type;
+        std::string text;
+    };
+
+    const Table& table;
+    std::vector<Token> tokens;
+    size_t pos = 0;
+    Program* program = nullptr;
+    size_t depth = 0;
+
+    Program compile(const std::string& expr);
+    void tokenize(const std::string& expr);
+
+    ExprType parse_or();
+    ExprType parse_and();
+    ExprType parse_not();
+    ExprType parse_comparison();
+    ExprType parse_additive();
+    ExprType parse_multiplicative();
+    ExprType parse_unary();
+    ExprType parse_primary();
+
+    bool match_keyword(const std::string& keyword);
+    bool match_symbol(const std::string& symbol);
+    void emit(OpCode op, int stack_effect, uint32_t arg = 0);
+    ExprType condition(ExprType type, const std::string& context);
+    ExprType promote(ExprType left, ExprType right, const std::string& op);
+};
+
+#endif // COMPILER_H
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include "../types.h"
+#include <cstdint>
+
+// Static type of an expression, resolved when it is compiled.
+enum class ExprType {
+    INTEGER,
+    REAL,
+    TEXT,
+    BOOLEAN
+};
+
+// Opcodes are specialized per operand type so the interpreter never has to
+// inspect a Value's variant index to decide what to do.
+enum class OpCode : uint8_t {
+    LOAD_INT,           // push row.values[arg] as int64
+    LOAD_REAL,          // push row.values[arg] as double
+    LOAD_TEXT,          // push pointer to row.values[arg] string
+    PUSH_INT,           // push int_value
+    PUSH_REAL,          // push real_value
+    PUSH_TEXT,          // push pointer to text_constants[arg]
+    INT_TO_REAL,        // convert top of stack
+    INT_TO_REAL_UNDER,  // convert the slot below the top
+
+    ADD_INT, SUB_INT, MUL_INT, DIV_INT, MOD_INT, NEG_INT,
+    ADD_REAL, SUB_REAL, MUL_REAL, DIV_REAL, NEG_REAL,
+
+    EQ_INT, NE_INT, LT_INT, LE_INT, GT_INT, GE_INT,
+    EQ_REAL, NE_REAL, LT_REAL, LE_REAL, GT_REAL, GE_REAL,
+    EQ_TEXT, NE_TEXT, LT_TEXT, LE_TEXT, GT_TEXT, GE_TEXT,
+
+    TRUTH,                 // normalize an INTEGER to 0/1
+    NOT,
+    JUMP_IF_FALSE_OR_POP,  // AND: keep a false top and jump to arg, else pop
+    JUMP_IF_TRUE_OR_POP    // OR: keep a true top and jump to arg, else pop
+};
+
+struct Instruction {
+    OpCode op;
+    uint32_t arg = 0;
+    int64_t int_value = 0;
+    double real_value = 0;
+};
+
+struct Program {
+    std::vector<Instruction> code;
+    std::vector<std::string> text_constants;
+    ExprType result_type = ExprType::BOOLEAN;
+    size_t max_stack = 0;
+};
+
+// One `column = expression` target of an UPDATE.
+struct Assignment {
+    size_t column_index = 0;
+    Program value;
+};
+
+#endif // PROGRAM_H
\ No newline at end of file
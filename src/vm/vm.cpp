@@ -0,0 +1,147 @@
+#include "vm.h"
+#include <stdexcept>
+
+bool VM::test(const Program& program, const Row& row) {
+    if (stack.size() < program.max_stack) {
+        stack.resize(program.max_stack);
+    }
+    return run(program, row).i != 0;
+}
+
+Value VM::evaluate(const Program& program, const Row& row) {
+    if (stack.size() < program.max_stack) {
+        stack.resize(program.max_stack);
+    }
+    
+    Slot result = run(program, row);
+    switch (program.result_type) {
+        case ExprType::REAL:
+            return result.r;
+        case ExprType::TEXT:
+            return *result.s;
+        case ExprType::INTEGER:
+        case ExprType::BOOLEAN:
+            break;
+    }
+    return result.i;
+}
+
+void VM::filter(const Program& program, const std::vector<Row>& rows, size_t begin, size_t end,
+                std::vector<size_t>& selection) {
+    if (stack.size() < program.max_stack) {
+        stack.resize(program.max_stack);
+    }
+    
+    for (size_t i = begin; i < end; ++i) {
+        if (run(program, rows[i]).i != 0) {
+            selection.push_back(i);
+        }
+    }
+}
+
+void VM::filter(const Program& program, const std::vector<Row>& rows, const std::vector<size_t>& candidates,
+                std::vector<size_t>& selection) {
+    if (stack.size() < program.max_stack) {
+        stack.resize(program.max_stack);
+    }
+    
+    for (size_t pos : candidates) {
+        if (run(program, rows[pos]).i != 0) {
+            selection.push_back(pos);
+        }
+    }
+}
+
+// The compiler has already checked types and stack depth, so no opcode
+// here validates its operands.
+VM::Slot VM::run(const Program& program, const Row& row) {
+    Slot* sp = stack.data();
+    const Instruction* code = program.code.data();
+    const size_t size = program.code.size();
+    size_t pc = 0;
+    
+    while (pc < size) {
+        const Instruction& ins = code[pc++];
+        switch (ins.op) {
+            case OpCode::LOAD_INT: (sp++)->i = *std::get_if<int64_t>(&row.values[ins.arg]); break;
+            case OpCode::LOAD_REAL: (sp++)->r = *std::get_if<double>(&row.values[ins.arg]); break;
+            case OpCode::LOAD_TEXT: (sp++)->s = std::get_if<std::string>(&row.values[ins.arg]); break;
+            case OpCode::PUSH_INT: (sp++)->i = ins.int_value; break;
+            case OpCode::PUSH_REAL: (sp++)->r = ins.real_value; break;
+            case OpCode::PUSH_TEXT: (sp++)->s = &program.text_constants[ins.arg]; break;
+            case OpCode::INT_TO_REAL: sp[-1].r = static_cast<double>(sp[-1].i); break;
+            case OpCode::INT_TO_REAL_UNDER: sp[-2].r = static_cast<double>(sp[-2].i); break;
+            
+            case OpCode::ADD_INT:
+                --sp;
+                if (__builtin_add_overflow(sp[-1].i, sp[0].i, &sp[-1].i)) throw std::runtime_error("Integer overflow");
+                break;
+            case OpCode::SUB_INT:
+                --sp;
+                if (__builtin_sub_overflow(sp[-1].i, sp[0].i, &sp[-1].i)) throw std::runtime_error("Integer overflow");
+                break;
+            case OpCode::MUL_INT:
+                --sp;
+                if (__builtin_mul_overflow(sp[-1].i, sp[0].i, &sp[-1].i)) throw std::runtime_error("Integer overflow");
+                break;
+            // INT64_MIN / -1 traps in hardware, so -1 goes through the
+            // negation path instead of the divide instruction.
+            case OpCode::DIV_INT:
+                --sp;
+                if (sp[0].i == 0) throw std::runtime_error("Division by zero");
+                if (sp[0].i == -1) {
+                    if (__builtin_sub_overflow(int64_t(0), sp[-1].i, &sp[-1].i)) {
+                        throw std::runtime_error("Integer overflow");
+                    }
+                } else {
+                    sp[-1].i /= sp[0].i;
+                }
+                break;
+            case OpCode::MOD_INT:
+                --sp;
+                if (sp[0].i == 0) throw std::runtime_error("Division by zero");
+                sp[-1].i = sp[0].i == -1 ? 0 : sp[-1].i % sp[0].i;
+                break;
+            case OpCode::NEG_INT:
+                if (__builtin_sub_overflow(int64_t(0), sp[-1].i, &sp[-1].i)) throw std::runtime_error("Integer overflow");
+                break;
+            case OpCode::ADD_REAL: --sp; sp[-1].r += sp[0].r; break;
+            case OpCode::SUB_REAL: --sp; sp[-1].r -= sp[0].r; break;
+            case OpCode::MUL_REAL: --sp; sp[-1].r *= sp[0].r; break;
+            case OpCode::DIV_REAL: --sp; sp[-1].r /= sp[0].r; break;
+            case OpCode::NEG_REAL: sp[-1].r = -sp[-1].r; break;
+            
+            case OpCode::EQ_INT: --sp; sp[-1].i = sp[-1].i == sp[0].i; break;
+            case OpCode::NE_INT: --sp; sp[-1].i = sp[-1].i != sp[0].i; break;
+            case OpCode::LT_INT: --sp; sp[-1].i = sp[-1].i < sp[0].i; break;
+            case OpCode::LE_INT: --sp; sp[-1].i = sp[-1].i <= sp[0].i; break;
+            case OpCode::GT_INT: --sp; sp[-1].i = sp[-1].i > sp[0].i; break;
+            case OpCode::GE_INT: --sp; sp[-1].i = sp[-1].i >= sp[0].i; break;
+            case OpCode::EQ_REAL: --sp; sp[-1].i = sp[-1].r == sp[0].r; break;
+            case OpCode::NE_REAL: --sp; sp[-1].i = sp[-1].r != sp[0].r; break;
+            case OpCode::LT_REAL: --sp; sp[-1].i = sp[-1].r < sp[0].r; break;
+            case OpCode::LE_REAL: --sp; sp[-1].i = sp[-1].r <= sp[0].r; break;
+            case OpCode::GT_REAL: --sp; sp[-1].i = sp[-1].r > sp[0].r; break;
+            case OpCode::GE_REAL: --sp; sp[-1].i = sp[-1].r >= sp[0].r; break;
+            case OpCode::EQ_TEXT: --sp; sp[-1].i = *sp[-1].s == *sp[0].s; break;
+            case OpCode::NE_TEXT: --sp; sp[-1].i = *sp[-1].s != *sp[0].s; break;
+            case OpCode::LT_TEXT: --sp; sp[-1].i = *sp[-1].s < *sp[0].s; break;
+            case OpCode::LE_TEXT: --sp; sp[-1].i = *sp[-1].s <= *sp[0].s; break;
+            case OpCode::GT_TEXT: --sp; sp[-1].i = *sp[-1].s > *sp[0].s; break;
+            case OpCode::GE_TEXT: --sp; sp[-1].i = *sp[-1].s >= *sp[0].s; break;
+            
+            case OpCode::TRUTH: sp[-1].i = sp[-1].i != 0; break;
+            case OpCode::NOT: sp[-1].i = sp[-1].i == 0; break;
+            case OpCode::JUMP_IF_FALSE_OR_POP:
+                if (sp[-1].i == 0) pc = ins.arg;
+                else --sp;
+                break;
+            case OpCode::JUMP_IF_TRUE_OR_POP:
+                if (sp[-1].i != 0) pc = ins.arg;
+                else --sp;
+                break;
+        }
+    }
+    
+    return sp[-1];
+}
\ No newline at end of file
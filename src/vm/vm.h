@@ -0,0 +1,35 @@
+#ifndef VM_H
+#define VM_H
+
+#include "program.h"
+
+// Stack interpreter for compiled expressions. A VM owns its operand stack,
+// so use one instance per thread.
+class VM {
+public:
+    VM() = default;
+    ~VM() = default;
+
+    bool test(const Program& program, const Row& row);
+    Value evaluate(const Program& program, const Row& row);
+
+    // Appends the positions in [begin, end) whose rows satisfy the predicate.
+    void filter(const Program& program, const std::vector<Row>& rows, size_t begin, size_t end,
+                std::vector<size_t>& selection);
+    // Same, for an explicit list of candidate positions.
+    void filter(const Program& program, const std::vector<Row>& rows, const std::vector<size_t>& candidates,
+                std::vector<size_t>& selection);
+
+private:
+    union Slot {
+        int64_t i;
+        double r;
+        const std::string* s;
+    };
+
+    std::vector<Slot> stack;
+
+    Slot run(const Program& program, const Row& row);
+};
+
+#endif // VM_H
\ No newline at end of file